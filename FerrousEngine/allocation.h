@@ -1,5 +1,8 @@
 #pragma once
 #include "stdafx.h"
+#include <atomic>
+#include <mutex>
+
 namespace fe {
 	class StackAllocator;
 
@@ -38,6 +41,7 @@ namespace fe {
 		void* alignForward(const void* p, uint8_t alignment);
 	};
 
+	/* The engine's shared allocator. Any thread may allocate from it: the free block list is guarded by a lock, and reference counts are atomic. */
 	class Memory : public FerrousAllocator {
 	public:
 		struct Page;
@@ -134,6 +138,7 @@ namespace fe {
 		Memory();
 		~Memory();
 
+		std::mutex _lock; /* Guards the pages, the free block list and the defragmentation cursor. */
 		Page* _pages;
 		Block* _blocks;
 		Page* _page_to_defrag; /* Next page to be defragged. */
@@ -47,6 +47,7 @@ namespace fe {
 	}
 
 	void Memory::reset(void) {
+		lock_guard<mutex> lock(_lock);
 		Page* p = _pages;
 		_page_to_defrag = _pages;
 		_blocks = nullptr;
@@ -70,6 +71,10 @@ namespace fe {
 		num_bytes += alignment;
 		assert(num_bytes < PAGE_FREE_SIZE); // Page size not large enough.
 
+		// Keep every block header aligned, so its reference count can be updated atomically. Pages are multiples of it, so this still fits.
+		num_bytes = (num_bytes + alignof(Block) - 1) & ~(alignof(Block) - 1);
+
+		lock_guard<mutex> lock(_lock);
 		Block* b = _blocks;
 		Block* prev = nullptr;
 
@@ -119,6 +124,8 @@ namespace fe {
 	void Memory::dealloc(void* p) {
 		char* temp = static_cast<char*>(p);
 		Block* b = reinterpret_cast<Block*>(temp - temp[-1] - BLOCK_HEADER_SIZE);
+
+		lock_guard<mutex> lock(_lock);
 		b->_next = _blocks;
 		_blocks = b;
 	}
@@ -137,23 +144,24 @@ namespace fe {
 	void Memory::ref(void* p) {
 		char* temp = static_cast<char*>(p);
 		Block* b = reinterpret_cast<Block*>(temp - temp[-1] - BLOCK_HEADER_SIZE);
-		b->_info._ref_count++;
+		atomic_ref<uint16_t>(b->_info._ref_count).fetch_add(1, memory_order_relaxed);
 	}
 
 	void Memory::deref(void* p) {
 		char* temp = static_cast<char*>(p);
 		Block* b = reinterpret_cast<Block*>(temp - temp[-1] - BLOCK_HEADER_SIZE);
-		b->_info._ref_count--;
-		if (b->_info._ref_count == 0)
+		if (atomic_ref<uint16_t>(b->_info._ref_count).fetch_sub(1, memory_order_acq_rel) == 1)
 			dealloc(p);
 	}
 
 	size_t Memory::getCapacity() {
+		lock_guard<mutex> lock(_lock);
 		return Memory::PAGE_SIZE* _page_count;
 	}
 
 	void Memory::defragment(size_t max_pages) {
 		assert(max_pages > 0);
+		lock_guard<mutex> lock(_lock);
 		Page* p = _page_to_defrag;
 		for (size_t i = 0; i < max_pages; i++) {
 			mergeSort(&_blocks);
@@ -252,6 +260,7 @@ namespace fe {
 	void Memory::outputDebug() {
 		cout << "Memory allocator analysis" << endl;
 		cout << "=========================" << endl;
+		lock_guard<mutex> lock(_lock);
 		size_t capacity = _page_count * PAGE_SIZE;
 		Block* b = _blocks;
 		uint32_t total_blocks = 0;
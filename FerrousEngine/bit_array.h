@@ -0,0 +1,214 @@
+#pragma once
+#include "bit_set.h"
+#include "allocation.h"
+
+namespace fe {
+	namespace collections {
+		/*	A dynamically sized array of bits, allocated from a FerrousAllocator. Binary operations process 256 bits per step with SSE2,
+			and require both arrays to have the same bit count.
+			e.g. BitArray dirty(entityCount); dirty.set(id); dirty.forEachSet([&](uint32_t i) { upload(i); }); dirty.clearAll(); */
+		class BitArray {
+		public:
+			static constexpr uint32_t NOT_FOUND = BitOps::NOT_FOUND;
+
+			/* Creates an array of bitCount cleared bits. An empty array does not allocate. */
+			BitArray(uint32_t bitCount = 0, FerrousAllocator* allocator = Memory::get()) {
+				_words = nullptr;
+				_bitCount = 0;
+				_wordCount = 0;
+				_allocator = allocator;
+				resize(bitCount);
+			}
+
+			BitArray(const BitArray& other) : BitArray(other._bitCount, other._allocator) {
+				memcpy(_words, other._words, _wordCount * sizeof(uint64_t));
+			}
+
+			BitArray(BitArray&& other) noexcept {
+				takeFrom(other);
+			}
+
+			~BitArray() {
+				release();
+			}
+
+			BitArray& operator=(const BitArray& other) {
+				if (this != &other) {
+					if (_wordCount != other._wordCount) {
+						release();
+						_bitCount = 0;
+						resize(other._bitCount);
+					}
+
+					_bitCount = other._bitCount;
+					memcpy(_words, other._words, _wordCount * sizeof(uint64_t));
+				}
+
+				return *this;
+			}
+
+			BitArray& operator=(BitArray&& other) noexcept {
+				if (this != &other) {
+					release();
+					takeFrom(other);
+				}
+
+				return *this;
+			}
+
+			inline bool get(uint32_t index) const {
+				checkIndex(index);
+				return (_words[index / BitOps::WORD_BITS] >> (index % BitOps::WORD_BITS)) & 1;
+			}
+
+			inline void set(uint32_t index) {
+				checkIndex(index);
+				_words[index / BitOps::WORD_BITS] |= 1ULL << (index % BitOps::WORD_BITS);
+			}
+
+			inline void set(uint32_t index, bool value) {
+				if (value)
+					set(index);
+				else
+					clear(index);
+			}
+
+			inline void clear(uint32_t index) {
+				checkIndex(index);
+				_words[index / BitOps::WORD_BITS] &= ~(1ULL << (index % BitOps::WORD_BITS));
+			}
+
+			/* Sets count bits, starting at startIndex. */
+			inline void setRange(uint32_t startIndex, uint32_t count) {
+				checkRange(startIndex, count);
+				BitOps::fillRange(_words, startIndex, count, true);
+			}
+
+			/* Clears count bits, starting at startIndex. */
+			inline void clearRange(uint32_t startIndex, uint32_t count) {
+				checkRange(startIndex, count);
+				BitOps::fillRange(_words, startIndex, count, false);
+			}
+
+			inline void setAll() {
+				BitOps::fillRange(_words, 0, _bitCount, true);
+			}
+
+			inline void clearAll() {
+				if (_wordCount > 0)
+					memset(_words, 0, _wordCount * sizeof(uint64_t));
+			}
+
+			/* Changes the number of bits. New bits are cleared. Keeps the existing allocation if it is already large enough. */
+			void resize(uint32_t bitCount) {
+				uint32_t wordCount = BitOps::getWordCount(bitCount);
+
+				if (wordCount > _wordCount) {
+					uint64_t* newWords = static_cast<uint64_t*>(_allocator->alloc(wordCount * sizeof(uint64_t), 16));
+					if (_wordCount > 0)
+						memcpy(newWords, _words, _wordCount * sizeof(uint64_t));
+
+					memset(&newWords[_wordCount], 0, (wordCount - _wordCount) * sizeof(uint64_t));
+					release();
+					_words = newWords;
+					_wordCount = wordCount;
+				}
+
+				// Keep every bit beyond the bit count cleared, so whole words can be counted and compared.
+				if (bitCount < _bitCount)
+					BitOps::fillRange(_words, bitCount, _bitCount - bitCount, false);
+
+				_bitCount = bitCount;
+			}
+
+			/* Binary operations throw IndexOutOfRangeExeption if other has a different bit count. */
+			inline void andWith(const BitArray& other) { checkSize(other); BitOps::andWith(_words, other._words, usedWordCount()); }
+			inline void orWith(const BitArray& other) { checkSize(other); BitOps::orWith(_words, other._words, usedWordCount()); }
+			inline void xorWith(const BitArray& other) { checkSize(other); BitOps::xorWith(_words, other._words, usedWordCount()); }
+
+			/* Clears every bit which is set in other. */
+			inline void andNotWith(const BitArray& other) { checkSize(other); BitOps::andNotWith(_words, other._words, usedWordCount()); }
+
+			/* Returns the number of set bits. */
+			inline uint32_t countSet() const { return BitOps::popCount(_words, _wordCount); }
+
+			inline bool any() const { return BitOps::any(_words, _wordCount); }
+			inline bool none() const { return !any(); }
+
+			/* Returns the index of the first set bit at or after startIndex, or NOT_FOUND if there is none. */
+			inline uint32_t findNextSet(uint32_t startIndex = 0) const {
+				return BitOps::findNextSet(_words, _wordCount, startIndex);
+			}
+
+			/* Calls func(index) for every set bit, in ascending order. */
+			template<typename Func>
+			inline void forEachSet(Func func) const {
+				BitOps::forEachSet(_words, _wordCount, func);
+			}
+
+			/* Gets the number of bits in the array. */
+			inline uint32_t bitCount() const { return _bitCount; }
+
+			inline uint64_t* words() { return _words; }
+			inline const uint64_t* words() const { return _words; }
+
+			inline BitArray& operator&=(const BitArray& other) { andWith(other); return *this; }
+			inline BitArray& operator|=(const BitArray& other) { orWith(other); return *this; }
+			inline BitArray& operator^=(const BitArray& other) { xorWith(other); return *this; }
+
+			inline bool operator==(const BitArray& other) const {
+				return _bitCount == other._bitCount && (_bitCount == 0 || memcmp(_words, other._words, usedWordCount() * sizeof(uint64_t)) == 0);
+			}
+
+			inline bool operator!=(const BitArray& other) const { return !(*this == other); }
+
+			inline bool operator[] (uint32_t index) const { return get(index); }
+
+		private:
+			uint64_t* _words;		/* 16-byte aligned, and a whole number of 128-bit blocks. */
+			uint32_t _bitCount;
+			uint32_t _wordCount;
+			FerrousAllocator* _allocator;
+
+			inline void checkIndex(uint32_t index) const {
+				if (index >= _bitCount)
+					throw IndexOutOfRangeExeption(index, _bitCount);
+			}
+
+			inline void checkRange(uint32_t startIndex, uint32_t count) const {
+				if (startIndex + count > _bitCount)
+					throw IndexOutOfRangeExeption(startIndex + count, _bitCount);
+			}
+
+			inline void checkSize(const BitArray& other) const {
+				if (other._bitCount != _bitCount)
+					throw IndexOutOfRangeExeption(other._bitCount, _bitCount);
+			}
+
+			/* The number of words which hold the bit count. Either array may have kept a larger allocation after shrinking. */
+			inline uint32_t usedWordCount() const {
+				return BitOps::getWordCount(_bitCount);
+			}
+
+			void takeFrom(BitArray& other) {
+				_words = other._words;
+				_bitCount = other._bitCount;
+				_wordCount = other._wordCount;
+				_allocator = other._allocator;
+
+				other._words = nullptr;
+				other._bitCount = 0;
+				other._wordCount = 0;
+			}
+
+			void release() {
+				if (_words == nullptr)
+					return;
+
+				_allocator->dealloc(_words);
+				_words = nullptr;
+				_wordCount = 0;
+			}
+		};
+	}
+}
\ No newline at end of file
@@ -0,0 +1,271 @@
+#pragma once
+#include "bits.h"
+#include "exceptions.h"
+#include <string.h>
+
+namespace fe {
+	namespace collections {
+		/*	Word-parallel operations on arrays of 64-bit words, shared by BitSet and BitArray.
+			Word counts passed to the binary operations must be even, and the arrays 16-byte aligned, so that SSE2 can process
+			them in whole 128-bit blocks. Two blocks (256 bits) are processed per loop iteration. */
+		class BitOps {
+		public:
+			static constexpr uint32_t WORD_BITS = 64;
+			static constexpr uint32_t NOT_FOUND = UINT32_MAX;
+
+			/* Returns the number of words needed to hold bitCount bits, rounded up to a whole number of 128-bit blocks. */
+			static constexpr uint32_t getWordCount(uint32_t bitCount) {
+				return ((bitCount + 127) / 128) * 2;
+			}
+
+			static inline void andWith(uint64_t* dest, const uint64_t* src, uint32_t wordCount) { combine<AndOp>(dest, src, wordCount); }
+			static inline void orWith(uint64_t* dest, const uint64_t* src, uint32_t wordCount) { combine<OrOp>(dest, src, wordCount); }
+			static inline void xorWith(uint64_t* dest, const uint64_t* src, uint32_t wordCount) { combine<XorOp>(dest, src, wordCount); }
+
+			/* Clears every bit of dest which is set in src. */
+			static inline void andNotWith(uint64_t* dest, const uint64_t* src, uint32_t wordCount) { combine<AndNotOp>(dest, src, wordCount); }
+
+			static inline uint32_t popCount(const uint64_t* words, uint32_t wordCount) {
+				uint32_t result = 0;
+				for (uint32_t i = 0; i < wordCount; i++)
+					result += Bits::popCount(words[i]);
+
+				return result;
+			}
+
+			static inline bool any(const uint64_t* words, uint32_t wordCount) {
+				for (uint32_t i = 0; i < wordCount; i++) {
+					if (words[i] != 0)
+						return true;
+				}
+
+				return false;
+			}
+
+			/* Sets or clears count bits, starting at start. Only the partial words at either end are masked. */
+			static void fillRange(uint64_t* words, uint32_t start, uint32_t count, bool value) {
+				if (count == 0)
+					return;
+
+				uint32_t end = start + count;
+				uint32_t firstWord = start / WORD_BITS;
+				uint32_t lastWord = (end - 1) / WORD_BITS;
+				uint64_t firstMask = ~0ULL << (start % WORD_BITS);
+				uint64_t lastMask = ~0ULL >> (WORD_BITS - 1 - ((end - 1) % WORD_BITS));
+
+				if (firstWord == lastWord) {
+					fillWord(words[firstWord], firstMask & lastMask, value);
+					return;
+				}
+
+				fillWord(words[firstWord], firstMask, value);
+				memset(&words[firstWord + 1], value ? 0xFF : 0, (lastWord - firstWord - 1) * sizeof(uint64_t));
+				fillWord(words[lastWord], lastMask, value);
+			}
+
+			/* Returns the index of the first set bit at or after start, or NOT_FOUND if there is none. */
+			static inline uint32_t findNextSet(const uint64_t* words, uint32_t wordCount, uint32_t start) {
+				uint32_t wordIndex = start / WORD_BITS;
+				if (wordIndex >= wordCount)
+					return NOT_FOUND;
+
+				uint64_t word = words[wordIndex] & (~0ULL << (start % WORD_BITS));
+				for (;;) {
+					if (word != 0)
+						return wordIndex * WORD_BITS + Bits::countTrailingZeros(word);
+
+					if (++wordIndex == wordCount)
+						return NOT_FOUND;
+
+					word = words[wordIndex];
+				}
+			}
+
+			/* Calls func(index) for every set bit, in order. Each word is scanned by repeatedly clearing its lowest set bit. */
+			template<typename Func>
+			static inline void forEachSet(const uint64_t* words, uint32_t wordCount, Func func) {
+				for (uint32_t i = 0; i < wordCount; i++) {
+					uint64_t word = words[i];
+					while (word != 0) {
+						func(i * WORD_BITS + Bits::countTrailingZeros(word));
+						word &= word - 1;
+					}
+				}
+			}
+
+		private:
+			static inline void fillWord(uint64_t& word, uint64_t mask, bool value) {
+				word = value ? (word | mask) : (word & ~mask);
+			}
+
+#ifdef FE_SSE2
+			struct AndOp {
+				static inline __m128i apply(__m128i a, __m128i b) { return _mm_and_si128(a, b); }
+			};
+
+			struct OrOp {
+				static inline __m128i apply(__m128i a, __m128i b) { return _mm_or_si128(a, b); }
+			};
+
+			struct XorOp {
+				static inline __m128i apply(__m128i a, __m128i b) { return _mm_xor_si128(a, b); }
+			};
+
+			struct AndNotOp {
+				static inline __m128i apply(__m128i a, __m128i b) { return _mm_andnot_si128(b, a); }
+			};
+
+			template<typename Op>
+			static inline void combine(uint64_t* dest, const uint64_t* src, uint32_t wordCount) {
+				assert((wordCount % 2) == 0);
+				__m128i* d = reinterpret_cast<__m128i*>(dest);
+				const __m128i* s = reinterpret_cast<const __m128i*>(src);
+				uint32_t blockCount = wordCount / 2;
+				uint32_t i = 0;
+
+				for (; i + 2 <= blockCount; i += 2) {
+					__m128i a = Op::apply(_mm_load_si128(&d[i]), _mm_load_si128(&s[i]));
+					__m128i b = Op::apply(_mm_load_si128(&d[i + 1]), _mm_load_si128(&s[i + 1]));
+					_mm_store_si128(&d[i], a);
+					_mm_store_si128(&d[i + 1], b);
+				}
+
+				if (i < blockCount)
+					_mm_store_si128(&d[i], Op::apply(_mm_load_si128(&d[i]), _mm_load_si128(&s[i])));
+			}
+#else
+			struct AndOp {
+				static inline uint64_t apply(uint64_t a, uint64_t b) { return a & b; }
+			};
+
+			struct OrOp {
+				static inline uint64_t apply(uint64_t a, uint64_t b) { return a | b; }
+			};
+
+			struct XorOp {
+				static inline uint64_t apply(uint64_t a, uint64_t b) { return a ^ b; }
+			};
+
+			struct AndNotOp {
+				static inline uint64_t apply(uint64_t a, uint64_t b) { return a & ~b; }
+			};
+
+			template<typename Op>
+			static inline void combine(uint64_t* dest, const uint64_t* src, uint32_t wordCount) {
+				for (uint32_t i = 0; i < wordCount; i++)
+					dest[i] = Op::apply(dest[i], src[i]);
+			}
+#endif
+		};
+
+		/*	A fixed-size set of N bits, stored inline. Binary operations process 256 bits per step with SSE2.
+			e.g. BitSet<1024> visible; visible.andWith(inFrustum); visible.forEachSet([&](uint32_t i) { draw(i); }); */
+		template<uint32_t N>
+		class BitSet {
+			static_assert(N > 0, "A BitSet requires at least one bit.");
+
+		public:
+			static constexpr uint32_t WORD_COUNT = BitOps::getWordCount(N);
+			static constexpr uint32_t NOT_FOUND = BitOps::NOT_FOUND;
+
+			BitSet() {
+				memset(_words, 0, sizeof(_words));
+			}
+
+			inline bool get(uint32_t index) const {
+				checkIndex(index);
+				return (_words[index / BitOps::WORD_BITS] >> (index % BitOps::WORD_BITS)) & 1;
+			}
+
+			inline void set(uint32_t index) {
+				checkIndex(index);
+				_words[index / BitOps::WORD_BITS] |= 1ULL << (index % BitOps::WORD_BITS);
+			}
+
+			inline void set(uint32_t index, bool value) {
+				if (value)
+					set(index);
+				else
+					clear(index);
+			}
+
+			inline void clear(uint32_t index) {
+				checkIndex(index);
+				_words[index / BitOps::WORD_BITS] &= ~(1ULL << (index % BitOps::WORD_BITS));
+			}
+
+			/* Sets count bits, starting at startIndex. */
+			inline void setRange(uint32_t startIndex, uint32_t count) {
+				checkRange(startIndex, count);
+				BitOps::fillRange(_words, startIndex, count, true);
+			}
+
+			/* Clears count bits, starting at startIndex. */
+			inline void clearRange(uint32_t startIndex, uint32_t count) {
+				checkRange(startIndex, count);
+				BitOps::fillRange(_words, startIndex, count, false);
+			}
+
+			inline void setAll() {
+				BitOps::fillRange(_words, 0, N, true);
+			}
+
+			inline void clearAll() {
+				memset(_words, 0, sizeof(_words));
+			}
+
+			inline void andWith(const BitSet& other) { BitOps::andWith(_words, other._words, WORD_COUNT); }
+			inline void orWith(const BitSet& other) { BitOps::orWith(_words, other._words, WORD_COUNT); }
+			inline void xorWith(const BitSet& other) { BitOps::xorWith(_words, other._words, WORD_COUNT); }
+
+			/* Clears every bit which is set in other. */
+			inline void andNotWith(const BitSet& other) { BitOps::andNotWith(_words, other._words, WORD_COUNT); }
+
+			/* Returns the number of set bits. */
+			inline uint32_t countSet() const { return BitOps::popCount(_words, WORD_COUNT); }
+
+			inline bool any() const { return BitOps::any(_words, WORD_COUNT); }
+			inline bool none() const { return !any(); }
+
+			/* Returns the index of the first set bit at or after startIndex, or NOT_FOUND if there is none. */
+			inline uint32_t findNextSet(uint32_t startIndex = 0) const {
+				return BitOps::findNextSet(_words, WORD_COUNT, startIndex);
+			}
+
+			/* Calls func(index) for every set bit, in ascending order. */
+			template<typename Func>
+			inline void forEachSet(Func func) const {
+				BitOps::forEachSet(_words, WORD_COUNT, func);
+			}
+
+			/* Gets the number of bits in the set. */
+			static constexpr uint32_t bitCount() { return N; }
+
+			inline uint64_t* words() { return _words; }
+			inline const uint64_t* words() const { return _words; }
+
+			inline BitSet& operator&=(const BitSet& other) { andWith(other); return *this; }
+			inline BitSet& operator|=(const BitSet& other) { orWith(other); return *this; }
+			inline BitSet& operator^=(const BitSet& other) { xorWith(other); return *this; }
+
+			inline bool operator==(const BitSet& other) const { return memcmp(_words, other._words, sizeof(_words)) == 0; }
+			inline bool operator!=(const BitSet& other) const { return !(*this == other); }
+
+			inline bool operator[] (uint32_t index) const { return get(index); }
+
+		private:
+			/* Bits at and beyond N are always 0, so whole words can be counted and compared. */
+			alignas(16) uint64_t _words[WORD_COUNT];
+
+			static inline void checkIndex(uint32_t index) {
+				if (index >= N)
+					throw IndexOutOfRangeExeption(index, N);
+			}
+
+			static inline void checkRange(uint32_t startIndex, uint32_t count) {
+				if (startIndex + count > N)
+					throw IndexOutOfRangeExeption(startIndex + count, N);
+			}
+		};
+	}
+}
\ No newline at end of file
@@ -0,0 +1,99 @@
+#pragma once
+#include "stdafx.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace fe {
+	/* Bit manipulation helpers, mapped to compiler intrinsics where available. */
+	class Bits {
+	public:
+		/* Returns the number of zero bits below the lowest set bit. value must not be 0. */
+		static inline uint32_t countTrailingZeros(const uint32_t value) {
+			assert(value != 0);
+#ifdef _MSC_VER
+			unsigned long index;
+			_BitScanForward(&index, value);
+			return index;
+#else
+			return __builtin_ctz(value);
+#endif
+		}
+
+		/* Returns the number of zero bits above the highest set bit. value must not be 0. */
+		static inline uint32_t countLeadingZeros(const uint32_t value) {
+			assert(value != 0);
+#ifdef _MSC_VER
+			unsigned long index;
+			_BitScanReverse(&index, value);
+			return 31 - index;
+#else
+			return __builtin_clz(value);
+#endif
+		}
+
+		/* Returns the number of zero bits below the lowest set bit. value must not be 0. */
+		static inline uint32_t countTrailingZeros(const uint64_t value) {
+			assert(value != 0);
+#if defined(_MSC_VER) && defined(_WIN64)
+			unsigned long index;
+			_BitScanForward64(&index, value);
+			return index;
+#elif defined(_MSC_VER)
+			uint32_t low = (uint32_t)value;
+			return low != 0 ? countTrailingZeros(low) : 32 + countTrailingZeros((uint32_t)(value >> 32));
+#else
+			return __builtin_ctzll(value);
+#endif
+		}
+
+		/* Returns the number of zero bits above the highest set bit. value must not be 0. */
+		static inline uint32_t countLeadingZeros(const uint64_t value) {
+			assert(value != 0);
+#if defined(_MSC_VER) && defined(_WIN64)
+			unsigned long index;
+			_BitScanReverse64(&index, value);
+			return 63 - index;
+#elif defined(_MSC_VER)
+			uint32_t high = (uint32_t)(value >> 32);
+			return high != 0 ? countLeadingZeros(high) : 32 + countLeadingZeros((uint32_t)value);
+#else
+			return __builtin_clzll(value);
+#endif
+		}
+
+		/* Returns the number of set bits. */
+		static inline uint32_t popCount(const uint32_t value) {
+#ifdef _MSC_VER
+			// __popcnt requires the POPCNT instruction, which SSE2 does not guarantee.
+			uint32_t v = value - ((value >> 1) & 0x55555555);
+			v = (v & 0x33333333) + ((v >> 2) & 0x33333333);
+			return (((v + (v >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24;
+#else
+			return __builtin_popcount(value);
+#endif
+		}
+
+		/* Returns the number of set bits. */
+		static inline uint32_t popCount(const uint64_t value) {
+#ifdef _MSC_VER
+			uint64_t v = value - ((value >> 1) & 0x5555555555555555ULL);
+			v = (v & 0x3333333333333333ULL) + ((v >> 2) & 0x3333333333333333ULL);
+			return (uint32_t)((((v + (v >> 4)) & 0x0F0F0F0F0F0F0F0FULL) * 0x0101010101010101ULL) >> 56);
+#else
+			return __builtin_popcountll(value);
+#endif
+		}
+
+		static inline bool isPowerOfTwo(const uint32_t value) {
+			return value != 0 && (value & (value - 1)) == 0;
+		}
+
+		/* Returns the smallest power of two that is greater than or equal to value. value must be between 1 and 2^31. */
+		static inline uint32_t nextPowerOfTwo(const uint32_t value) {
+			assert(value > 0 && value <= (1U << 31));
+			return value == 1 ? 1 : 1U << (32 - countLeadingZeros(value - 1));
+		}
+	};
+}
\ No newline at end of file
@@ -4,17 +4,21 @@
 
 namespace fe {
 	namespace collections {
-		// Base class for all ferrous collection types.
-		template<typename T>
+		/*	Base class for all ferrous collection types, using the curiously recurring template pattern (CRTP).
+			Derived must implement clear(), contains(), add(), remove() and copyTo(). Calls made through the base class are resolved at
+			compile-time, so they can be inlined and collections do not carry a vtable pointer.
+			Use CollectionRef<T> where a collection must be passed around without knowing its type. */
+		template<typename T, typename Derived>
 		class Collection {
 		public:
-			virtual void clear() = 0;
+			inline void clear() { derived().clear(); }
 
-			virtual bool contains(T item) = 0;
-			virtual bool add(T item) = 0;
-			virtual bool remove(T item) = 0;
+			inline bool contains(const T& item) const { return derived().contains(item); }
+			inline bool add(const T& item) { return derived().add(item); }
+			inline bool remove(const T& item) { return derived().remove(item); }
 
-			virtual void copyTo(T* dest, uint32_t startIndex, uint32_t copyCount) = 0;
+			/* Copy-constructs copyCount items, starting at startIndex, into dest. dest should be uninitialized memory, or hold trivially-copyable items. */
+			inline void copyTo(T* dest, uint32_t startIndex, uint32_t copyCount) const { derived().copyTo(dest, startIndex, copyCount); }
 
 			inline uint32_t count() const { return _count; }
 			inline bool isEmpty() const { return _count == 0; }
@@ -24,6 +28,54 @@ namespace fe {
 				_count = 0;
 			}
 			uint32_t _count;
+
+		private:
+			inline Derived& derived() { return static_cast<Derived&>(*this); }
+			inline const Derived& derived() const { return static_cast<const Derived&>(*this); }
+		};
+
+		/*	A non-owning, type-erased reference to any collection of T. Dispatches through a shared table of function pointers,
+			so the cost of indirection is only paid by code which actually needs polymorphism. The collection must outlive the reference. */
+		template<typename T>
+		class CollectionRef {
+		public:
+			template<typename Derived>
+			CollectionRef(Collection<T, Derived>& collection) :
+				_collection(static_cast<Derived*>(&collection)), _ops(&OPERATIONS<Derived>) { }
+
+			inline void clear() { _ops->clear(_collection); }
+
+			inline bool contains(const T& item) const { return _ops->contains(_collection, item); }
+			inline bool add(const T& item) { return _ops->add(_collection, item); }
+			inline bool remove(const T& item) { return _ops->remove(_collection, item); }
+
+			inline void copyTo(T* dest, uint32_t startIndex, uint32_t copyCount) const { _ops->copyTo(_collection, dest, startIndex, copyCount); }
+
+			inline uint32_t count() const { return _ops->count(_collection); }
+			inline bool isEmpty() const { return count() == 0; }
+
+		private:
+			struct Operations {
+				void (*clear)(void* c);
+				bool (*contains)(const void* c, const T& item);
+				bool (*add)(void* c, const T& item);
+				bool (*remove)(void* c, const T& item);
+				void (*copyTo)(const void* c, T* dest, uint32_t startIndex, uint32_t copyCount);
+				uint32_t (*count)(const void* c);
+			};
+
+			template<typename Derived>
+			static constexpr Operations OPERATIONS = {
+				[](void* c) { static_cast<Derived*>(c)->clear(); },
+				[](const void* c, const T& item) { return static_cast<const Derived*>(c)->contains(item); },
+				[](void* c, const T& item) { return static_cast<Derived*>(c)->add(item); },
+				[](void* c, const T& item) { return static_cast<Derived*>(c)->remove(item); },
+				[](const void* c, T* dest, uint32_t startIndex, uint32_t copyCount) { static_cast<const Derived*>(c)->copyTo(dest, startIndex, copyCount); },
+				[](const void* c) { return static_cast<const Derived*>(c)->count(); },
+			};
+
+			void* _collection;
+			const Operations* _ops;
 		};
 	}
 }
\ No newline at end of file
@@ -0,0 +1,547 @@
+#pragma once
+#include "dictionary.h"
+#include "concurrent_epoch.h"
+#include <atomic>
+#include <mutex>
+
+namespace fe {
+	namespace collections {
+		/*	A hash map which any number of threads can read and write at once.
+			The map is split into shards by hash, and each shard has its own lock which only writers take (lock striping), so writers to
+			different shards never contend. Readers take no lock at all: entries are immutable nodes which a writer replaces rather than
+			modifies, so a reader always sees either the old or the new node in full. Replaced nodes and outgrown tables are freed once
+			no Epoch::Guard which could still see them remains (see Epoch).
+
+			Values are returned by copy, never by reference, since another thread may replace the entry at any time. Several readers may copy
+			the same value at once, so copying a V must be safe from several threads, as it is for FeString.
+			Each shard holds at most MAX_SHARD_ENTRIES entries. */
+		template <typename K, typename V, typename F = DefaultKeyHash<K>, typename E = DefaultKeyEquals<K>>
+		class ConcurrentDictionary {
+			template <typename H, typename C, typename = void>
+			struct IsTransparent : std::false_type {};
+
+			template <typename H, typename C>
+			struct IsTransparent<H, C, std::void_t<typename H::is_transparent, typename C::is_transparent>> : std::true_type {};
+
+			template <typename Q>
+			using EnableLookup = std::enable_if_t<IsTransparent<F, E>::value || std::is_same<Q, PrehashedKey<K>>::value>;
+
+			/* Readers only ever read key, value and hash. The retirement fields are only used once the node has been unlinked. */
+			struct Node {
+				K key;
+				V value;
+				uint64_t hash;
+				Node* nextRetired;
+				uint64_t retiredEpoch;
+			};
+
+			/*	An open-addressing table of node pointers. A slot is null until a node is stored in it, and a removed node leaves a tombstone.
+				Slots are stored in blocks which each fit in one Memory page. A table with a single block stores it after the block pointers. */
+			struct Table {
+				uint32_t mask;
+				uint32_t blockCount;
+				Table* nextRetired;
+				uint64_t retiredEpoch;
+				std::atomic<Node*>* blocks[1];	/* blockCount pointers. */
+
+				inline std::atomic<Node*>& slot(uint32_t index) const {
+					return blocks[index / BLOCK_SLOTS][index % BLOCK_SLOTS];
+				}
+			};
+
+			struct alignas(FE_CACHE_LINE_SIZE) Shard {
+				std::atomic<Table*> table;
+				std::mutex writeLock;
+				std::atomic<uint32_t> count;	/* Number of live nodes. Only written under the lock, but read by count(). */
+				uint32_t used;		/* Number of non-null slots, including tombstones. */
+			};
+
+			static constexpr uint32_t BLOCK_SLOTS = 512;
+			static constexpr uint32_t MAX_BLOCKS = 512;
+			static_assert(sizeof(std::atomic<Node*>) * BLOCK_SLOTS + sizeof(Table) + alignof(Table) < Memory::PAGE_FREE_SIZE, "A table block must fit in one page.");
+			static_assert(sizeof(std::atomic<Node*>*) * MAX_BLOCKS + sizeof(Table) + alignof(Table) < Memory::PAGE_FREE_SIZE, "A table must fit in one page.");
+
+		public:
+			static constexpr uint32_t DEFAULT_SHARD_COUNT = 16;
+
+			/* The most entries one shard can hold: 3/4 of the largest table. Adding an entry to a full shard throws. */
+			static constexpr uint32_t MAX_SHARD_ENTRIES = BLOCK_SLOTS * MAX_BLOCKS / 4 * 3;
+
+			/* shardCount is rounded up to the next power of two. More shards allow more concurrent writers. */
+			ConcurrentDictionary(uint32_t shardCount = DEFAULT_SHARD_COUNT, FerrousAllocator* allocator = Memory::get()) {
+				_shardCount = Bits::nextPowerOfTwo(shardCount);
+				_shardShift = 64 - Bits::countTrailingZeros(_shardCount);
+				_allocator = allocator;
+				_retiredNodes = nullptr;
+				_retiredTables = nullptr;
+				_retiredCount = 0;
+				_collectAt = COLLECT_THRESHOLD;
+				_shards = static_cast<Shard*>(_allocator->alloc(sizeof(Shard) * _shardCount, FE_CACHE_LINE_SIZE));
+
+				for (uint32_t i = 0; i < _shardCount; i++) {
+					Shard* shard = new (&_shards[i]) Shard();
+					shard->table.store(nullptr, std::memory_order_relaxed);
+					shard->count.store(0, std::memory_order_relaxed);
+					shard->used = 0;
+				}
+			}
+
+			ConcurrentDictionary(const ConcurrentDictionary& other) = delete;
+			ConcurrentDictionary& operator=(const ConcurrentDictionary& other) = delete;
+
+			/* No other thread may be using the dictionary. */
+			~ConcurrentDictionary() {
+				for (uint32_t i = 0; i < _shardCount; i++) {
+					Table* table = _shards[i].table.load(std::memory_order_relaxed);
+					if (table != nullptr) {
+						for (uint32_t s = 0; s <= table->mask; s++) {
+							Node* node = table->slot(s).load(std::memory_order_relaxed);
+							if (isLive(node))
+								destroyNode(node);
+						}
+
+						destroyTable(table);
+					}
+
+					_shards[i].~Shard();
+				}
+
+				collectList(_retiredNodes, UINT64_MAX, [this](Node* node) { destroyNode(node); });
+				collectList(_retiredTables, UINT64_MAX, [this](Table* table) { destroyTable(table); });
+
+				_allocator->dealloc(_shards);
+			}
+
+			bool containsKey(const K& key) const {
+				Epoch::Guard guard;
+				return findNode(key, hashOf(key)) != nullptr;
+			}
+
+			/*	Transparent lookup. Accepts a PrehashedKey<K>, or any type accepted by both F and E if they define is_transparent.
+				e.g. A ConcurrentDictionary<FeString, V> can be queried with a FeStringView or a U"literal", without constructing a FeString. */
+			template <typename Q, typename = EnableLookup<Q>>
+			bool containsKey(const Q& key) const {
+				Epoch::Guard guard;
+				return findNode(key, hashOf(key)) != nullptr;
+			}
+
+			V get(const K& key) const {
+				return getValue(key);
+			}
+
+			template <typename Q, typename = EnableLookup<Q>>
+			V get(const Q& key) const {
+				return getValue(key);
+			}
+
+			bool tryGet(const K& key, V& value) const {
+				return tryGetValue(key, value);
+			}
+
+			template <typename Q, typename = EnableLookup<Q>>
+			bool tryGet(const Q& key, V& value) const {
+				return tryGetValue(key, value);
+			}
+
+			/* Adds an entry, or replaces the value of an existing entry with the same key. */
+			void put(const K& key, const V& value) {
+				insert(key, hashOf(key), [&value]() -> const V& { return value; }, true);
+			}
+
+			/* Adds an entry if the key is not already present. Returns false, and leaves the existing entry unchanged, if it is. */
+			bool tryAdd(const K& key, const V& value) {
+				return insert(key, hashOf(key), [&value]() -> const V& { return value; }, false);
+			}
+
+			/*	Returns the value of the entry with the specified key, or adds one with the value returned by create() if there is none.
+				Only one thread can create the value for a key, so e.g. a resource is never loaded twice. create() runs under the shard's lock,
+				so it must not use the dictionary. */
+			template <typename Create>
+			V getOrAdd(const K& key, Create create) {
+				uint64_t hash = hashOf(key);
+				{
+					Epoch::Guard guard;
+					if (const Node* node = findNode(key, hash))
+						return node->value;
+				}
+
+				Shard& shard = getShard(hash);
+				std::lock_guard<std::mutex> lock(shard.writeLock);
+				Table* table = shard.table.load(std::memory_order_relaxed);
+
+				// Another thread may have added the key while this one waited for the lock.
+				uint32_t index = findSlot(table, key, hash);
+				if (index != NOT_FOUND)
+					return table->slot(index).load(std::memory_order_relaxed)->value;
+
+				return addNode(shard, key, hash, create)->value;
+			}
+
+			bool remove(const K& key) {
+				return removeKey(key, hashOf(key));
+			}
+
+			template <typename Q, typename = EnableLookup<Q>>
+			bool remove(const Q& key) {
+				return removeKey(key, hashOf(key));
+			}
+
+			/* Removes all entries. */
+			void clear() {
+				for (uint32_t i = 0; i < _shardCount; i++) {
+					Shard& shard = _shards[i];
+					std::lock_guard<std::mutex> lock(shard.writeLock);
+
+					Table* table = shard.table.load(std::memory_order_relaxed);
+					if (table == nullptr)
+						continue;
+
+					shard.table.store(nullptr, std::memory_order_release);
+					shard.count.store(0, std::memory_order_relaxed);
+					shard.used = 0;
+
+					std::lock_guard<std::mutex> retireLock(_retireLock);
+					for (uint32_t s = 0; s <= table->mask; s++) {
+						Node* node = table->slot(s).load(std::memory_order_relaxed);
+						if (isLive(node))
+							retire(node);
+					}
+
+					retire(table);
+				}
+			}
+
+			/* Frees removed entries and outgrown tables which no reader can still see. This also happens automatically as memory is retired. */
+			void reclaim() {
+				std::lock_guard<std::mutex> lock(_retireLock);
+				collect();
+			}
+
+			/* Gets the number of entries. It may already be out of date if other threads are writing to the dictionary. */
+			uint32_t count() const {
+				uint32_t total = 0;
+				for (uint32_t i = 0; i < _shardCount; i++)
+					total += _shards[i].count.load(std::memory_order_relaxed);
+
+				return total;
+			}
+
+			inline uint32_t shardCount() const {
+				return _shardCount;
+			}
+
+		private:
+			static constexpr uint32_t NOT_FOUND = UINT32_MAX;
+			static constexpr uint32_t MIN_TABLE_CAPACITY = 16;
+			static constexpr uint32_t COLLECT_THRESHOLD = 64;	/* Smallest number of retired blocks which triggers a collection. */
+
+			Shard* _shards;
+			uint32_t _shardCount;
+			uint32_t _shardShift;
+			FerrousAllocator* _allocator;
+			F _hashFunc;
+			E _equals;
+
+			std::mutex _retireLock;			/* Guards the retired lists, which writers to every shard add to. */
+			Node* _retiredNodes;			/* Unlinked nodes which may still be visible to a reader, linked through Node::nextRetired. */
+			Table* _retiredTables;
+			uint32_t _retiredCount;
+			uint32_t _collectAt;			/* Retired count which triggers the next collection. */
+
+			/* A non-null slot which does not hold a live node. Never dereferenced. */
+			static inline Node* tombstone() {
+				return reinterpret_cast<Node*>(alignof(Node));
+			}
+
+			static inline bool isLive(const Node* node) {
+				return node != nullptr && node != tombstone();
+			}
+
+			template <typename Q>
+			inline uint64_t hashOf(const Q& key) const {
+				return _hashFunc(key);
+			}
+
+			inline uint64_t hashOf(const PrehashedKey<K>& key) const {
+				return key.hash;
+			}
+
+			template <typename Q>
+			inline bool keyEquals(const K& key, const Q& other) const {
+				return _equals(key, other);
+			}
+
+			inline bool keyEquals(const K& key, const PrehashedKey<K>& other) const {
+				return _equals(key, other.key);
+			}
+
+			/* Shards are picked with the top bits of the hash, since tables index with the bottom bits. */
+			inline Shard& getShard(uint64_t hash) const {
+				return _shards[_shardCount > 1 ? (hash >> _shardShift) : 0];
+			}
+
+			/* Finds a live node without locking. The caller must hold an Epoch::Guard for as long as it uses the node. */
+			template <typename Q>
+			const Node* findNode(const Q& key, uint64_t hash) const {
+				const Table* table = getShard(hash).table.load(std::memory_order_acquire);
+				if (table == nullptr)
+					return nullptr;
+
+				for (uint32_t i = (uint32_t)hash & table->mask, probes = 0; probes <= table->mask; i = (i + 1) & table->mask, probes++) {
+					const Node* node = table->slot(i).load(std::memory_order_acquire);
+					if (node == nullptr)
+						return nullptr;
+
+					if (node != tombstone() && node->hash == hash && keyEquals(node->key, key))
+						return node;
+				}
+
+				return nullptr;
+			}
+
+			/* Finds the slot of a live node. The caller must hold the shard's lock. */
+			template <typename Q>
+			uint32_t findSlot(const Table* table, const Q& key, uint64_t hash) const {
+				if (table == nullptr)
+					return NOT_FOUND;
+
+				for (uint32_t i = (uint32_t)hash & table->mask, probes = 0; probes <= table->mask; i = (i + 1) & table->mask, probes++) {
+					const Node* node = table->slot(i).load(std::memory_order_relaxed);
+					if (node == nullptr)
+						return NOT_FOUND;
+
+					if (node != tombstone() && node->hash == hash && keyEquals(node->key, key))
+						return i;
+				}
+
+				return NOT_FOUND;
+			}
+
+			template <typename Q>
+			V getValue(const Q& key) const {
+				Epoch::Guard guard;
+				const Node* node = findNode(key, hashOf(key));
+				if (node == nullptr)
+					throw "Key not found.";
+
+				return node->value;
+			}
+
+			template <typename Q>
+			bool tryGetValue(const Q& key, V& value) const {
+				Epoch::Guard guard;
+				const Node* node = findNode(key, hashOf(key));
+				if (node == nullptr)
+					return false;
+
+				value = node->value;
+				return true;
+			}
+
+			template <typename GetValue>
+			bool insert(const K& key, uint64_t hash, GetValue getValue, bool replace) {
+				Shard& shard = getShard(hash);
+				std::lock_guard<std::mutex> lock(shard.writeLock);
+				Table* table = shard.table.load(std::memory_order_relaxed);
+
+				uint32_t index = findSlot(table, key, hash);
+				if (index == NOT_FOUND) {
+					addNode(shard, key, hash, getValue);
+					return true;
+				}
+
+				if (!replace)
+					return false;
+
+				// Readers may still be copying the old node's value, so it is swapped for a new node rather than modified.
+				Node* node = createNode(key, hash, getValue);
+				Node* old = table->slot(index).exchange(node, std::memory_order_acq_rel);
+
+				std::lock_guard<std::mutex> retireLock(_retireLock);
+				retire(old);
+				return true;
+			}
+
+			template <typename Q>
+			bool removeKey(const Q& key, uint64_t hash) {
+				Shard& shard = getShard(hash);
+				std::lock_guard<std::mutex> lock(shard.writeLock);
+				Table* table = shard.table.load(std::memory_order_relaxed);
+
+				uint32_t index = findSlot(table, key, hash);
+				if (index == NOT_FOUND)
+					return false;
+
+				Node* old = table->slot(index).exchange(tombstone(), std::memory_order_acq_rel);
+				shard.count.fetch_sub(1, std::memory_order_relaxed);
+
+				std::lock_guard<std::mutex> retireLock(_retireLock);
+				retire(old);
+				return true;
+			}
+
+			/* Creates a node and stores it in the shard, growing the shard's table first if needed. The caller must hold the shard's lock. */
+			template <typename GetValue>
+			Node* addNode(Shard& shard, const K& key, uint64_t hash, GetValue& getValue) {
+				Table* table = shard.table.load(std::memory_order_relaxed);
+
+				// Keep the table at most 3/4 full, counting tombstones, so probe sequences stay short and always reach a null slot.
+				if (table == nullptr || (shard.used + 1) * 4 > (table->mask + 1) * 3)
+					table = rebuild(shard, table);
+
+				Node* node = createNode(key, hash, getValue);
+
+				uint32_t i = (uint32_t)node->hash & table->mask;
+				while (table->slot(i).load(std::memory_order_relaxed) != nullptr)
+					i = (i + 1) & table->mask;
+
+				table->slot(i).store(node, std::memory_order_release);
+				shard.used++;
+				shard.count.fetch_add(1, std::memory_order_relaxed);
+				return node;
+			}
+
+			/*	Copies the live nodes into a new table sized for the shard's count, dropping tombstones, and publishes it.
+				Readers still probing the old table see the same nodes, so the old table is retired rather than freed. */
+			Table* rebuild(Shard& shard, Table* oldTable) {
+				uint32_t count = shard.count.load(std::memory_order_relaxed);
+				if (count >= MAX_SHARD_ENTRIES)
+					throw "The dictionary shard is full.";
+
+				uint32_t capacity = Bits::nextPowerOfTwo((count + 1) * 2);
+				if (capacity < MIN_TABLE_CAPACITY)
+					capacity = MIN_TABLE_CAPACITY;
+				else if (capacity > BLOCK_SLOTS * MAX_BLOCKS)
+					capacity = BLOCK_SLOTS * MAX_BLOCKS;
+
+				Table* table = createTable(capacity);
+				if (oldTable != nullptr) {
+					for (uint32_t s = 0; s <= oldTable->mask; s++) {
+						Node* node = oldTable->slot(s).load(std::memory_order_relaxed);
+						if (!isLive(node))
+							continue;
+
+						uint32_t i = (uint32_t)node->hash & table->mask;
+						while (table->slot(i).load(std::memory_order_relaxed) != nullptr)
+							i = (i + 1) & table->mask;
+
+						table->slot(i).store(node, std::memory_order_relaxed);
+					}
+				}
+
+				shard.table.store(table, std::memory_order_release);
+				shard.used = count;
+
+				if (oldTable != nullptr) {
+					std::lock_guard<std::mutex> retireLock(_retireLock);
+					retire(oldTable);
+				}
+
+				return table;
+			}
+
+			/* Allocates a table of empty slots. */
+			Table* createTable(uint32_t capacity) {
+				uint32_t blockCount = capacity > BLOCK_SLOTS ? capacity / BLOCK_SLOTS : 1;
+				size_t headerSize = sizeof(Table) + sizeof(std::atomic<Node*>*) * (blockCount - 1);
+				size_t size = blockCount == 1 ? headerSize + sizeof(std::atomic<Node*>) * capacity : headerSize;
+
+				char* memory = static_cast<char*>(_allocator->alloc(size, alignof(Table)));
+				Table* table = reinterpret_cast<Table*>(memory);
+				table->mask = capacity - 1;
+				table->blockCount = blockCount;
+				table->nextRetired = nullptr;
+				table->retiredEpoch = 0;
+
+				if (blockCount == 1) {
+					table->blocks[0] = reinterpret_cast<std::atomic<Node*>*>(memory + headerSize);
+				}
+				else {
+					for (uint32_t b = 0; b < blockCount; b++)
+						table->blocks[b] = static_cast<std::atomic<Node*>*>(_allocator->alloc(sizeof(std::atomic<Node*>) * BLOCK_SLOTS, alignof(std::atomic<Node*>)));
+				}
+
+				for (uint32_t i = 0; i < capacity; i++)
+					new (&table->slot(i)) std::atomic<Node*>(nullptr);
+
+				return table;
+			}
+
+			/* Frees a table, but not its nodes. */
+			void destroyTable(Table* table) {
+				if (table->blockCount > 1) {
+					for (uint32_t b = 0; b < table->blockCount; b++)
+						_allocator->dealloc(table->blocks[b]);
+				}
+
+				_allocator->dealloc(table);
+			}
+
+			/* Allocates a node, and copies the key and the value returned by getValue() into it. */
+			template <typename GetValue>
+			Node* createNode(const K& key, uint64_t hash, GetValue& getValue) {
+				void* memory = _allocator->alloc(sizeof(Node), alignof(Node));
+				try {
+					return new (memory) Node{ key, getValue(), hash, nullptr, 0 };
+				}
+				catch (...) {
+					_allocator->dealloc(memory);
+					throw;
+				}
+			}
+
+			/* Destroys and frees a node. */
+			inline void destroyNode(Node* node) {
+				node->~Node();
+				_allocator->dealloc(node);
+			}
+
+			/*	Queues an unlinked node or table to be freed once no reader can see it. The caller must hold _retireLock.
+				The retired lists are linked through the retired memory itself, so retiring never allocates, however long a reader stalls. */
+			template <typename T>
+			void retire(T* item) {
+				item->retiredEpoch = Epoch::current();
+				item->nextRetired = getRetiredList<T>();
+				getRetiredList<T>() = item;
+
+				if (++_retiredCount >= _collectAt)
+					collect();
+			}
+
+			template <typename T>
+			inline T*& getRetiredList() {
+				if constexpr (std::is_same<T, Node>::value)
+					return _retiredNodes;
+				else
+					return _retiredTables;
+			}
+
+			/* Frees all retired memory which no reader can still see. The caller must hold _retireLock. */
+			void collect() {
+				uint64_t safe = Epoch::safeEpoch();
+				collectList(_retiredNodes, safe, [this](Node* node) { destroyNode(node); });
+				collectList(_retiredTables, safe, [this](Table* table) { destroyTable(table); });
+
+				// If a stalled reader is holding memory back, wait for more to be retired before trying again.
+				_collectAt = _retiredCount * 2 > COLLECT_THRESHOLD ? _retiredCount * 2 : COLLECT_THRESHOLD;
+			}
+
+			/* Releases every item in a retired list which was retired before the safe epoch. */
+			template <typename T, typename Release>
+			void collectList(T*& head, uint64_t safe, Release release) {
+				T** link = &head;
+				while (*link != nullptr) {
+					T* item = *link;
+					if (item->retiredEpoch < safe) {
+						*link = item->nextRetired;
+						release(item);
+						_retiredCount--;
+					}
+					else {
+						link = &item->nextRetired;
+					}
+				}
+			}
+		};
+	}
+}
\ No newline at end of file
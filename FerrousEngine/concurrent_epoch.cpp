@@ -0,0 +1,65 @@
+#include "concurrent_epoch.h"
+
+namespace fe {
+	Epoch::Participant Epoch::_participants[Epoch::MAX_THREADS];
+	std::atomic<uint64_t> Epoch::_epoch(1);
+
+	/* Each thread claims a participant slot the first time it enters a guard, and returns it when the thread exits. */
+	struct EpochThreadState {
+		Epoch::Participant* participant = nullptr;
+		uint32_t depth = 0;
+
+		Epoch::Participant* get() {
+			if (participant != nullptr)
+				return participant;
+
+			for (uint32_t i = 0; i < Epoch::MAX_THREADS; i++) {
+				bool expected = false;
+				if (Epoch::_participants[i].claimed.compare_exchange_strong(expected, true)) {
+					participant = &Epoch::_participants[i];
+					return participant;
+				}
+			}
+
+			assert(false && "More than Epoch::MAX_THREADS threads are using epoch guards.");
+			return nullptr;
+		}
+
+		~EpochThreadState() {
+			if (participant != nullptr) {
+				participant->epoch.store(0, std::memory_order_release);
+				participant->claimed.store(false, std::memory_order_release);
+			}
+		}
+	};
+
+	static thread_local EpochThreadState _threadState;
+
+	Epoch::Guard::Guard() {
+		if (_threadState.depth++ > 0)
+			return;
+
+		// The fence keeps the reader's loads of shared pointers from being reordered before its epoch is published.
+		_threadState.get()->epoch.store(_epoch.load(std::memory_order_relaxed), std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+	}
+
+	Epoch::Guard::~Guard() {
+		if (--_threadState.depth > 0)
+			return;
+
+		_threadState.participant->epoch.store(0, std::memory_order_release);
+	}
+
+	uint64_t Epoch::safeEpoch() {
+		uint64_t oldest = _epoch.fetch_add(1, std::memory_order_seq_cst) + 1;
+
+		for (uint32_t i = 0; i < MAX_THREADS; i++) {
+			uint64_t epoch = _participants[i].epoch.load(std::memory_order_seq_cst);
+			if (epoch != 0 && epoch < oldest)
+				oldest = epoch;
+		}
+
+		return oldest;
+	}
+}
\ No newline at end of file
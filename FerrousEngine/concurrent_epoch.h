@@ -0,0 +1,44 @@
+#pragma once
+#include "stdafx.h"
+#include <atomic>
+
+namespace fe {
+	/*	Epoch-based memory reclamation, for lock-free readers of concurrent containers.
+		A reader holds an Epoch::Guard while it may touch shared memory. A writer which unlinks memory records the current epoch instead of
+		freeing it, and only frees it once safeEpoch() has passed that epoch, by which point every guard which could have seen it has ended.
+		Entering a guard is a single store to a cache line owned by the calling thread. Guards may be nested. */
+	class Epoch {
+	public:
+		/* The largest number of threads which can hold a guard at the same time. */
+		static constexpr uint32_t MAX_THREADS = 128;
+
+		class Guard {
+		public:
+			Guard();
+			~Guard();
+
+			Guard(const Guard& other) = delete;
+			Guard& operator=(const Guard& other) = delete;
+		};
+
+		/* Returns the current global epoch. Memory unlinked now should be retired with this epoch. */
+		static inline uint64_t current() {
+			return _epoch.load(std::memory_order_seq_cst);
+		}
+
+		/*	Advances the global epoch, then returns the oldest epoch which a thread inside a guard may still be reading from.
+			Memory retired in an earlier epoch is no longer reachable by any reader, and can be freed. */
+		static uint64_t safeEpoch();
+
+	private:
+		struct alignas(FE_CACHE_LINE_SIZE) Participant {
+			std::atomic<uint64_t> epoch;	/* The epoch the thread entered its outermost guard in, or 0 if it is not inside a guard. */
+			std::atomic<bool> claimed;
+		};
+
+		friend struct EpochThreadState;
+
+		static Participant _participants[MAX_THREADS];
+		static std::atomic<uint64_t> _epoch;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,204 @@
+#pragma once
+#include "paged_ring.h"
+#include "exceptions.h"
+#include <atomic>
+#include <utility>
+
+namespace fe {
+	namespace collections {
+		/*	A bounded, lock-free queue which any number of threads can push to and pop from (Dmitry Vyukov's algorithm).
+			Each cell carries a sequence number, which tells a producer when the cell is free and a consumer when it holds an item.
+			Pushing to a full queue, or popping from an empty one, fails instead of blocking. */
+		template<typename T>
+		class MpmcQueue {
+			struct Cell {
+				std::atomic<size_t> sequence;
+				alignas(T) unsigned char storage[sizeof(T)];
+
+				inline T* item() { return reinterpret_cast<T*>(storage); }
+			};
+
+			/* Rounds capacity up to the next power of two, or throws if it is greater than MAX_CAPACITY. */
+			static inline uint32_t getRingCapacity(uint32_t capacity) {
+				if (capacity > MAX_CAPACITY)
+					throw IndexOutOfRangeExeption(capacity, MAX_CAPACITY);
+
+				return Bits::nextPowerOfTwo(capacity < 2 ? 2 : capacity);
+			}
+
+		public:
+			/* The largest capacity. Cells are stored in page-sized blocks, so this is far more than fits in one page. */
+			static constexpr uint32_t MAX_CAPACITY = PagedRing<Cell>::MAX_CAPACITY;
+
+			/* Capacity is rounded up to the next power of two. Throws if that is greater than MAX_CAPACITY. */
+			MpmcQueue(uint32_t capacity, FerrousAllocator* allocator = Memory::get()) : _cells(getRingCapacity(capacity), allocator) {
+				_capacity = _cells.capacity();
+				for (size_t i = 0; i < _capacity; i++)
+					new (&_cells[i].sequence) std::atomic<size_t>(i);
+
+				_enqueuePos.store(0, std::memory_order_relaxed);
+				_dequeuePos.store(0, std::memory_order_relaxed);
+			}
+
+			MpmcQueue(const MpmcQueue& other) = delete;
+			MpmcQueue& operator=(const MpmcQueue& other) = delete;
+
+			/* Destroys any items which were not popped. No other thread may be using the queue. */
+			~MpmcQueue() {
+				size_t end = _enqueuePos.load(std::memory_order_relaxed);
+				for (size_t pos = _dequeuePos.load(std::memory_order_relaxed); pos != end; pos++)
+					_cells[pos].item()->~T();
+			}
+
+			inline bool tryPush(const T& item) { return tryEmplace(item); }
+			inline bool tryPush(T&& item) { return tryEmplace(std::move(item)); }
+
+			/* Constructs an item in place at the back of the queue. Returns false if the queue is full. */
+			template<typename... Args>
+			bool tryEmplace(Args&&... args) {
+				size_t pos = _enqueuePos.load(std::memory_order_relaxed);
+				Cell* cell;
+
+				for (;;) {
+					cell = &_cells[pos];
+					size_t sequence = cell->sequence.load(std::memory_order_acquire);
+					intptr_t diff = (intptr_t)sequence - (intptr_t)pos;
+
+					if (diff == 0) {
+						if (_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+							break;
+					}
+					else if (diff < 0) {
+						return false; // The cell still holds an item from the previous lap.
+					}
+					else {
+						pos = _enqueuePos.load(std::memory_order_relaxed);
+					}
+				}
+
+				new (cell->item()) T(std::forward<Args>(args)...);
+				cell->sequence.store(pos + 1, std::memory_order_release);
+				return true;
+			}
+
+			/* Moves the item at the front of the queue into result. Returns false if the queue is empty. */
+			bool tryPop(T& result) {
+				size_t pos = _dequeuePos.load(std::memory_order_relaxed);
+				Cell* cell;
+
+				for (;;) {
+					cell = &_cells[pos];
+					size_t sequence = cell->sequence.load(std::memory_order_acquire);
+					intptr_t diff = (intptr_t)sequence - (intptr_t)(pos + 1);
+
+					if (diff == 0) {
+						if (_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+							break;
+					}
+					else if (diff < 0) {
+						return false; // The cell has not been written yet.
+					}
+					else {
+						pos = _dequeuePos.load(std::memory_order_relaxed);
+					}
+				}
+
+				popCell(cell, pos, result);
+				return true;
+			}
+
+			/*	Pushes up to count items from src, claiming every cell with a single compare-and-swap.
+				Returns the number of items pushed, which is less than count if the queue fills up. */
+			uint32_t tryPushBatch(const T* src, uint32_t count) {
+				size_t pos;
+				uint32_t claimed = claimBatch(_enqueuePos, count, 0, pos);
+
+				for (uint32_t i = 0; i < claimed; i++) {
+					Cell* cell = &_cells[pos + i];
+					new (cell->item()) T(src[i]);
+					cell->sequence.store(pos + i + 1, std::memory_order_release);
+				}
+
+				return claimed;
+			}
+
+			/*	Pops up to count items into dest, claiming every cell with a single compare-and-swap.
+				dest must hold count constructed items, which are assigned to. Returns the number of items popped. */
+			uint32_t tryPopBatch(T* dest, uint32_t count) {
+				size_t pos;
+				uint32_t claimed = claimBatch(_dequeuePos, count, 1, pos);
+
+				for (uint32_t i = 0; i < claimed; i++)
+					popCell(&_cells[pos + i], pos + i, dest[i]);
+
+				return claimed;
+			}
+
+			/* Returns an approximate number of items. It may already be out of date if other threads are using the queue. */
+			inline uint32_t approximateCount() const {
+				size_t enqueued = _enqueuePos.load(std::memory_order_relaxed);
+				size_t dequeued = _dequeuePos.load(std::memory_order_relaxed);
+				return enqueued > dequeued ? (uint32_t)(enqueued - dequeued) : 0;
+			}
+
+			inline uint32_t capacity() const { return (uint32_t)_capacity; }
+
+		private:
+			PagedRing<Cell> _cells;
+			size_t _capacity;
+
+			// Producers and consumers each get their own cache line, so they do not invalidate each other's position.
+			alignas(FE_CACHE_LINE_SIZE) std::atomic<size_t> _enqueuePos;
+			alignas(FE_CACHE_LINE_SIZE) std::atomic<size_t> _dequeuePos;
+			char _padding[FE_CACHE_LINE_SIZE - sizeof(std::atomic<size_t>)];
+
+			/*	Claims up to count consecutive cells from position, which are ready when their sequence is their position plus offset, and
+				stores the first claimed position in pos. As in tryEmplace() and tryPop(), another thread claiming the first cell first is
+				retried from the new position; only a first cell which is not ready yet means the queue is full (or empty). */
+			uint32_t claimBatch(std::atomic<size_t>& position, uint32_t count, size_t offset, size_t& pos) {
+				pos = position.load(std::memory_order_relaxed);
+				if (count == 0)
+					return 0;
+
+				for (;;) {
+					size_t sequence = _cells[pos].sequence.load(std::memory_order_acquire);
+					intptr_t diff = (intptr_t)sequence - (intptr_t)(pos + offset);
+
+					if (diff == 0) {
+						uint32_t claimed = countReady(pos, count, offset);
+						if (claimed > 0 && position.compare_exchange_weak(pos, pos + claimed, std::memory_order_relaxed))
+							return claimed;
+					}
+					else if (diff < 0) {
+						return 0;
+					}
+					else {
+						pos = position.load(std::memory_order_relaxed);
+					}
+				}
+			}
+
+			/* Counts how many consecutive cells, starting at pos, have a sequence of their position plus offset. */
+			inline uint32_t countReady(size_t pos, uint32_t count, size_t offset) const {
+				uint32_t ready = 0;
+				while (ready < count && ready < _capacity) {
+					size_t sequence = _cells[pos + ready].sequence.load(std::memory_order_acquire);
+					if (sequence != pos + ready + offset)
+						break;
+
+					ready++;
+				}
+
+				return ready;
+			}
+
+			/* Moves the item out of a claimed cell, and marks the cell free for the producer of the next lap. */
+			inline void popCell(Cell* cell, size_t pos, T& result) {
+				T* item = cell->item();
+				result = std::move(*item);
+				item->~T();
+				cell->sequence.store(pos + _capacity, std::memory_order_release);
+			}
+		};
+	}
+}
\ No newline at end of file
@@ -0,0 +1,137 @@
+#pragma once
+#include "paged_ring.h"
+#include "exceptions.h"
+#include <atomic>
+#include <utility>
+
+namespace fe {
+	namespace collections {
+		/*	A bounded, lock-free ring buffer for exactly one producer thread and one consumer thread.
+			Each side keeps a cached copy of the other side's index, so it only reads the shared index (and takes a cache miss)
+			when the cached copy says the buffer is full or empty. */
+		template<typename T>
+		class SpscQueue {
+			/* Rounds capacity up to the next power of two, or throws if it is greater than MAX_CAPACITY. */
+			static inline uint32_t getRingCapacity(uint32_t capacity) {
+				if (capacity > MAX_CAPACITY)
+					throw IndexOutOfRangeExeption(capacity, MAX_CAPACITY);
+
+				return Bits::nextPowerOfTwo(capacity < 2 ? 2 : capacity);
+			}
+
+		public:
+			/* The largest capacity. Items are stored in page-sized blocks, so this is far more than fits in one page. */
+			static constexpr uint32_t MAX_CAPACITY = PagedRing<T>::MAX_CAPACITY;
+
+			/* Capacity is rounded up to the next power of two. Throws if that is greater than MAX_CAPACITY. */
+			SpscQueue(uint32_t capacity, FerrousAllocator* allocator = Memory::get()) : _items(getRingCapacity(capacity), allocator) {
+				_capacity = _items.capacity();
+				_head.store(0, std::memory_order_relaxed);
+				_tail.store(0, std::memory_order_relaxed);
+				_cachedHead = 0;
+				_cachedTail = 0;
+			}
+
+			SpscQueue(const SpscQueue& other) = delete;
+			SpscQueue& operator=(const SpscQueue& other) = delete;
+
+			/* Destroys any items which were not popped. Neither thread may be using the queue. */
+			~SpscQueue() {
+				size_t tail = _tail.load(std::memory_order_relaxed);
+				for (size_t pos = _head.load(std::memory_order_relaxed); pos != tail; pos++)
+					_items[pos].~T();
+			}
+
+			inline bool tryPush(const T& item) { return tryEmplace(item); }
+			inline bool tryPush(T&& item) { return tryEmplace(std::move(item)); }
+
+			/* Constructs an item in place at the back of the queue. Producer thread only. Returns false if the queue is full. */
+			template<typename... Args>
+			bool tryEmplace(Args&&... args) {
+				size_t tail = _tail.load(std::memory_order_relaxed);
+				if (tail - _cachedHead == _capacity) {
+					_cachedHead = _head.load(std::memory_order_acquire);
+					if (tail - _cachedHead == _capacity)
+						return false;
+				}
+
+				new (&_items[tail]) T(std::forward<Args>(args)...);
+				_tail.store(tail + 1, std::memory_order_release);
+				return true;
+			}
+
+			/* Moves the item at the front of the queue into result. Consumer thread only. Returns false if the queue is empty. */
+			bool tryPop(T& result) {
+				size_t head = _head.load(std::memory_order_relaxed);
+				if (head == _cachedTail) {
+					_cachedTail = _tail.load(std::memory_order_acquire);
+					if (head == _cachedTail)
+						return false;
+				}
+
+				T* item = &_items[head];
+				result = std::move(*item);
+				item->~T();
+				_head.store(head + 1, std::memory_order_release);
+				return true;
+			}
+
+			/* Pushes up to count items from src, publishing them all at once. Producer thread only. Returns the number of items pushed. */
+			uint32_t pushBatch(const T* src, uint32_t count) {
+				size_t tail = _tail.load(std::memory_order_relaxed);
+				size_t space = _capacity - (tail - _cachedHead);
+				if (space < count) {
+					_cachedHead = _head.load(std::memory_order_acquire);
+					space = _capacity - (tail - _cachedHead);
+				}
+
+				uint32_t pushed = count < space ? count : (uint32_t)space;
+				for (uint32_t i = 0; i < pushed; i++)
+					new (&_items[tail + i]) T(src[i]);
+
+				_tail.store(tail + pushed, std::memory_order_release);
+				return pushed;
+			}
+
+			/*	Pops up to count items into dest, releasing their slots all at once. Consumer thread only.
+				dest must hold count constructed items, which are assigned to. Returns the number of items popped. */
+			uint32_t popBatch(T* dest, uint32_t count) {
+				size_t head = _head.load(std::memory_order_relaxed);
+				size_t available = _cachedTail - head;
+				if (available < count) {
+					_cachedTail = _tail.load(std::memory_order_acquire);
+					available = _cachedTail - head;
+				}
+
+				uint32_t popped = count < available ? count : (uint32_t)available;
+				for (uint32_t i = 0; i < popped; i++) {
+					T* item = &_items[head + i];
+					dest[i] = std::move(*item);
+					item->~T();
+				}
+
+				_head.store(head + popped, std::memory_order_release);
+				return popped;
+			}
+
+			/* Returns an approximate number of items. It may already be out of date if the other thread is using the queue. */
+			inline uint32_t approximateCount() const {
+				return (uint32_t)(_tail.load(std::memory_order_relaxed) - _head.load(std::memory_order_relaxed));
+			}
+
+			inline uint32_t capacity() const { return (uint32_t)_capacity; }
+
+		private:
+			PagedRing<T> _items;
+			size_t _capacity;
+
+			// The consumer's index and the producer's cached copy of it share a line, as do the producer's index and the consumer's copy.
+			// Each line is only written by one thread.
+			alignas(FE_CACHE_LINE_SIZE) std::atomic<size_t> _head;	/* Next position to pop. Written by the consumer. */
+			size_t _cachedTail;		/* The consumer's copy of _tail. */
+			alignas(FE_CACHE_LINE_SIZE) std::atomic<size_t> _tail;	/* Next position to push. Written by the producer. */
+			size_t _cachedHead;		/* The producer's copy of _head. */
+			char _padding[FE_CACHE_LINE_SIZE - sizeof(std::atomic<size_t>) - sizeof(size_t)];
+		};
+	}
+}
\ No newline at end of file
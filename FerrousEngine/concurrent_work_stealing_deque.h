@@ -0,0 +1,106 @@
+#pragma once
+#include "allocation.h"
+#include "bits.h"
+#include <atomic>
+
+namespace fe {
+	namespace collections {
+		/*	A bounded Chase-Lev work-stealing deque of pointers. The owner thread pushes and pops at the bottom, like a stack, so it works on
+			its most recent (and cache-warm) items first. Any other thread may steal from the top, taking the oldest item. Only a pop or
+			steal of the last item needs a compare-and-swap; push and pop are otherwise plain loads and stores. */
+		template<typename T>
+		class WorkStealingDeque {
+		public:
+			/* Capacity is rounded up to the next power of two. */
+			WorkStealingDeque(uint32_t capacity, FerrousAllocator* allocator = Memory::get()) {
+				_capacity = Bits::nextPowerOfTwo(capacity < 2 ? 2 : capacity);
+				_mask = _capacity - 1;
+				_allocator = allocator;
+				_items = static_cast<std::atomic<T*>*>(_allocator->alloc(sizeof(std::atomic<T*>) * _capacity, FE_CACHE_LINE_SIZE));
+
+				for (uint32_t i = 0; i < _capacity; i++)
+					new (&_items[i]) std::atomic<T*>(nullptr);
+
+				_top.store(0, std::memory_order_relaxed);
+				_bottom.store(0, std::memory_order_relaxed);
+			}
+
+			WorkStealingDeque(const WorkStealingDeque& other) = delete;
+			WorkStealingDeque& operator=(const WorkStealingDeque& other) = delete;
+
+			~WorkStealingDeque() {
+				_allocator->dealloc(_items);
+			}
+
+			/* Pushes an item onto the bottom. Owner thread only. Returns false if the deque is full. */
+			bool tryPush(T* item) {
+				int64_t bottom = _bottom.load(std::memory_order_relaxed);
+				int64_t top = _top.load(std::memory_order_acquire);
+				if (bottom - top >= (int64_t)_capacity)
+					return false;
+
+				_items[bottom & _mask].store(item, std::memory_order_relaxed);
+				_bottom.store(bottom + 1, std::memory_order_release);
+				return true;
+			}
+
+			/* Pops the most recently pushed item. Owner thread only. Returns nullptr if the deque is empty, or a thief took the last item. */
+			T* tryPop() {
+				int64_t bottom = _bottom.load(std::memory_order_relaxed) - 1;
+				_bottom.store(bottom, std::memory_order_relaxed);
+
+				// The fence orders the bottom store before the top load, so the owner and a thief cannot both take the last item.
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				int64_t top = _top.load(std::memory_order_relaxed);
+
+				if (top > bottom) {
+					_bottom.store(bottom + 1, std::memory_order_relaxed);
+					return nullptr;
+				}
+
+				T* item = _items[bottom & _mask].load(std::memory_order_relaxed);
+				if (top == bottom) {
+					// Last item. Race any thieves for it, by claiming it from the top as they would.
+					if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+						item = nullptr;
+
+					_bottom.store(bottom + 1, std::memory_order_relaxed);
+				}
+
+				return item;
+			}
+
+			/* Takes the oldest item. Any thread. Returns nullptr if the deque is empty, or another thread took the item first. */
+			T* trySteal() {
+				int64_t top = _top.load(std::memory_order_acquire);
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				int64_t bottom = _bottom.load(std::memory_order_acquire);
+
+				if (top >= bottom)
+					return nullptr;
+
+				T* item = _items[top & _mask].load(std::memory_order_relaxed);
+				if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+					return nullptr;
+
+				return item;
+			}
+
+			/* An approximate number of items, which may be out of date by the time it is returned. */
+			inline uint32_t approximateCount() const {
+				int64_t count = _bottom.load(std::memory_order_relaxed) - _top.load(std::memory_order_relaxed);
+				return count > 0 ? (uint32_t)count : 0;
+			}
+
+			inline uint32_t capacity() const { return _capacity; }
+
+		private:
+			alignas(FE_CACHE_LINE_SIZE) std::atomic<int64_t> _top;
+			alignas(FE_CACHE_LINE_SIZE) std::atomic<int64_t> _bottom;
+			alignas(FE_CACHE_LINE_SIZE) std::atomic<T*>* _items;
+			uint32_t _capacity;
+			uint32_t _mask;
+			FerrousAllocator* _allocator;
+		};
+	}
+}
\ No newline at end of file
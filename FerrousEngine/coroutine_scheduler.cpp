@@ -0,0 +1,67 @@
+#include "coroutine_scheduler.h"
+
+#ifdef FE_COROUTINES
+#include "priority_queue.h"
+
+namespace fe {
+	/* A delayed coroutine, ordered by due time, then by the order it was queued in. */
+	struct CoroutineTimer {
+		double dueTime;
+		uint64_t order;
+		std::coroutine_handle<> handle;
+
+		inline bool operator <(const CoroutineTimer& other) const {
+			return dueTime < other.dueTime || (dueTime == other.dueTime && order < other.order);
+		}
+	};
+
+	std::atomic<CoroutineScheduler::MainThreadAwaiter*> CoroutineScheduler::_queued(nullptr);
+
+	/* Only touched by the thread which calls update(), so they may allocate through Memory. Created on first use. */
+	static collections::PriorityQueue<CoroutineTimer>* _timers = nullptr;
+	static uint64_t _timerOrder = 0;
+
+	void CoroutineScheduler::enqueue(MainThreadAwaiter* awaiter) {
+		MainThreadAwaiter* head = _queued.load(std::memory_order_relaxed);
+		do {
+			awaiter->_next = head;
+		} while (!_queued.compare_exchange_weak(head, awaiter, std::memory_order_release, std::memory_order_relaxed));
+	}
+
+	void CoroutineScheduler::update(GameTime* time) {
+		double now = time->getTotalTime();
+
+		// Take everything queued so far. Coroutines queued from here on, including by those resumed below, wait for the next update().
+		// The stack is newest-first, so reverse it to resume coroutines in the order they were queued.
+		MainThreadAwaiter* queued = _queued.exchange(nullptr, std::memory_order_acquire);
+		MainThreadAwaiter* ready = nullptr;
+		while (queued != nullptr) {
+			MainThreadAwaiter* next = queued->_next;
+			queued->_next = ready;
+			ready = queued;
+			queued = next;
+		}
+
+		// Resuming a coroutine may destroy its awaiter, so read the next one first.
+		while (ready != nullptr) {
+			MainThreadAwaiter* next = ready->_next;
+
+			// A delay starts counting from the first update() to see it, since game time is only read here.
+			if (ready->_delayMs > 0) {
+				if (_timers == nullptr)
+					_timers = new (Memory::get()->allocType<collections::PriorityQueue<CoroutineTimer>>()) collections::PriorityQueue<CoroutineTimer>();
+
+				_timers->push(CoroutineTimer{ now + ready->_delayMs, _timerOrder++, ready->_handle });
+			}
+			else {
+				ready->_handle.resume();
+			}
+
+			ready = next;
+		}
+
+		while (_timers != nullptr && !_timers->isEmpty() && _timers->top().dueTime <= now)
+			_timers->pop().handle.resume();
+	}
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,140 @@
+#pragma once
+#include "coroutine_task.h"
+
+#ifdef FE_COROUTINES
+#include "job_system.h"
+#include "game_time.h"
+#include "stream.h"
+#include <atomic>
+
+namespace fe {
+	/*	Starts tasks, and moves coroutines between the JobSystem and the main thread. The main thread is the one which calls update(),
+		which FerrousInstance does before every onUpdate(). Awaiters queue themselves without allocating, since they live in the suspended
+		coroutine's frame, so any thread may await them.
+		e.g.	Task<> loadLevel(FileStream* file) {
+					LevelHeader header;
+					co_await CoroutineScheduler::readBytes(*file, (char*)&header, sizeof(header));	// Reads on a job thread.
+					co_await CoroutineScheduler::resumeOnMainThread();									// Safe to use Memory again.
+					...
+				}
+				CoroutineScheduler::spawn(loadLevel(file)); */
+	class CoroutineScheduler {
+	public:
+		/* An awaiter which the main thread resumes during update(), once its delay has passed. */
+		class MainThreadAwaiter {
+		public:
+			MainThreadAwaiter(double delayMs) : _delayMs(delayMs), _next(nullptr) { }
+
+			inline bool await_ready() const noexcept { return false; }
+
+			inline void await_suspend(std::coroutine_handle<> handle) {
+				_handle = handle;
+				CoroutineScheduler::enqueue(this);
+			}
+
+			inline void await_resume() const noexcept { }
+
+		private:
+			friend class CoroutineScheduler;
+
+			std::coroutine_handle<> _handle;
+			double _delayMs;
+			MainThreadAwaiter* _next;
+		};
+
+		/* An awaiter which resumes the coroutine as a job. */
+		class JobAwaiter {
+		public:
+			/* Does not suspend if the calling thread cannot run jobs, since the job would run immediately on it anyway. */
+			inline bool await_ready() const noexcept { return !JobSystem::isJobThread(); }
+
+			inline void await_suspend(std::coroutine_handle<> handle) {
+				JobSystem::run([handle] { handle.resume(); });
+			}
+
+			inline void await_resume() const noexcept { }
+		};
+
+		/*	An awaiter which reads from a stream on a job thread, then resumes the coroutine on that thread. Nothing else may use the stream
+			until the read completes. Stream errors are rethrown to the awaiting coroutine. */
+		class ReadAwaiter {
+		public:
+			ReadAwaiter(Stream& stream, char* dest, size_t numBytes) : _stream(&stream), _dest(dest), _numBytes(numBytes) { }
+
+			inline bool await_ready() const noexcept { return false; }
+
+			bool await_suspend(std::coroutine_handle<> handle) {
+				// Outside the job system, read now and continue without suspending.
+				if (!JobSystem::isJobThread()) {
+					read();
+					return false;
+				}
+
+				_handle = handle;
+				ReadAwaiter* self = this;
+				JobSystem::run([self] {
+					self->read();
+					self->_handle.resume();
+				});
+
+				return true;
+			}
+
+			inline void await_resume() {
+				if (_exception)
+					std::rethrow_exception(_exception);
+			}
+
+		private:
+			Stream* _stream;
+			char* _dest;
+			size_t _numBytes;
+			std::coroutine_handle<> _handle;
+			std::exception_ptr _exception;
+
+			inline void read() {
+				try {
+					_stream->readBytes(_dest, _numBytes);
+				}
+				catch (...) {
+					_exception = std::current_exception();
+				}
+			}
+		};
+
+		/* Starts a task on the calling thread, which runs until its first suspension. The task destroys itself once complete. */
+		template<typename T>
+		static void spawn(Task<T>&& task) {
+			task.detach().resume();
+		}
+
+		/* Starts a task as a job. */
+		template<typename T>
+		static void spawnOnJobs(Task<T>&& task) {
+			auto handle = task.detach();
+			JobSystem::run([handle] { handle.resume(); });
+		}
+
+		/* Resumes the coroutine during the next update(), on the main thread. Awaiting it from the main thread waits one update. */
+		static inline MainThreadAwaiter resumeOnMainThread() { return MainThreadAwaiter(0); }
+
+		/* Resumes the coroutine on the main thread, during the first update() at least the specified game time later. */
+		static inline MainThreadAwaiter delay(double milliseconds) { return MainThreadAwaiter(milliseconds); }
+
+		/* Resumes the coroutine as a job, so the work which follows runs in parallel with the main thread. */
+		static inline JobAwaiter resumeOnJobs() { return JobAwaiter(); }
+
+		/* Reads numBytes from the stream into dest on a job thread, without blocking the awaiting thread. */
+		static inline ReadAwaiter readBytes(Stream& stream, char* dest, size_t numBytes) { return ReadAwaiter(stream, dest, numBytes); }
+
+		/*	Resumes every coroutine queued for the main thread, and every delay which has elapsed by time->getTotalTime(). Coroutines queued
+			while update() runs are resumed by the next update(). Must always be called from the same thread. */
+		static void update(GameTime* time);
+
+	private:
+		static void enqueue(MainThreadAwaiter* awaiter);
+
+		static std::atomic<MainThreadAwaiter*> _queued;
+	};
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,183 @@
+#pragma once
+#include "stdafx.h"
+
+#ifdef FE_COROUTINES
+#include <coroutine>
+#include <exception>
+#include <utility>
+#include <new>
+
+namespace fe {
+	template<typename T>
+	class Task;
+
+	/* The part of a Task's promise which does not depend on its result type. */
+	class TaskPromiseBase {
+	public:
+		/* Resumes whichever coroutine awaited the task, or destroys the frame of a detached task. */
+		struct FinalAwaiter {
+			inline bool await_ready() const noexcept { return false; }
+
+			template<typename Promise>
+			std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+				TaskPromiseBase& promise = handle.promise();
+				std::coroutine_handle<> continuation = promise._continuation;
+
+				if (promise._detached)
+					handle.destroy();
+
+				return continuation ? continuation : std::noop_coroutine();
+			}
+
+			inline void await_resume() const noexcept { }
+		};
+
+		/* Tasks are lazy: they do not start until they are awaited, or spawned with CoroutineScheduler::spawn(). */
+		inline std::suspend_always initial_suspend() const noexcept { return {}; }
+		inline FinalAwaiter final_suspend() const noexcept { return {}; }
+
+		void unhandled_exception() {
+			// Nothing can observe the exception of a detached task, so treat it like an exception escaping a thread.
+			if (_detached)
+				std::terminate();
+
+			_exception = std::current_exception();
+		}
+
+	protected:
+		template<typename T>
+		friend class Task;
+
+		std::coroutine_handle<> _continuation;
+		std::exception_ptr _exception;
+		bool _detached = false;
+
+		inline void rethrowIfFailed() {
+			if (_exception)
+				std::rethrow_exception(_exception);
+		}
+	};
+
+	template<typename T>
+	class TaskPromise : public TaskPromiseBase {
+	public:
+		TaskPromise() : _hasValue(false) { }
+
+		~TaskPromise() {
+			if (_hasValue)
+				reinterpret_cast<T*>(_value)->~T();
+		}
+
+		Task<T> get_return_object() noexcept;
+
+		template<typename U>
+		void return_value(U&& value) {
+			new (_value) T(std::forward<U>(value));
+			_hasValue = true;
+		}
+
+		T takeResult() {
+			rethrowIfFailed();
+			return std::move(*reinterpret_cast<T*>(_value));
+		}
+
+	private:
+		alignas(T) unsigned char _value[sizeof(T)];
+		bool _hasValue;
+	};
+
+	template<>
+	class TaskPromise<void> : public TaskPromiseBase {
+	public:
+		Task<void> get_return_object() noexcept;
+
+		inline void return_void() const noexcept { }
+
+		inline void takeResult() {
+			rethrowIfFailed();
+		}
+	};
+
+	/*	A coroutine which produces a T, awaited with co_await. A task does not start until it is awaited, and the awaiting coroutine is
+		resumed directly by the task when it completes, on whichever thread completed it. An exception thrown by the task is rethrown to the
+		awaiting coroutine. Use CoroutineScheduler to start a task from ordinary code, or to move a task between threads.
+		e.g. Task<Texture*> loadTexture(FeString path) { ...; co_await CoroutineScheduler::resumeOnMainThread(); co_return texture; } */
+	template<typename T = void>
+	class Task {
+	public:
+		using promise_type = TaskPromise<T>;
+		using Handle = std::coroutine_handle<promise_type>;
+
+		Task() : _handle(nullptr) { }
+
+		explicit Task(Handle handle) : _handle(handle) { }
+
+		Task(Task&& other) noexcept : _handle(other._handle) {
+			other._handle = nullptr;
+		}
+
+		Task(const Task& other) = delete;
+		Task& operator=(const Task& other) = delete;
+
+		Task& operator=(Task&& other) noexcept {
+			if (this != &other) {
+				if (_handle)
+					_handle.destroy();
+
+				_handle = other._handle;
+				other._handle = nullptr;
+			}
+
+			return *this;
+		}
+
+		/* Destroys the coroutine frame. A task must not be destroyed while it is running, unless it was detached. */
+		~Task() {
+			if (_handle)
+				_handle.destroy();
+		}
+
+		inline bool isValid() const { return static_cast<bool>(_handle); }
+
+		inline bool isDone() const { return _handle && _handle.done(); }
+
+		/* Gives up ownership of the coroutine, which destroys itself once complete. Returns the handle, which can be resumed to start it. */
+		Handle detach() {
+			Handle handle = _handle;
+			handle.promise()._detached = true;
+			_handle = nullptr;
+			return handle;
+		}
+
+		/* Awaiting an empty task, e.g. one which was moved from or detached, throws instead of resuming a null coroutine. */
+		inline bool await_ready() const {
+			if (!_handle)
+				throw "Cannot await an empty task.";
+
+			return _handle.done();
+		}
+
+		/* Starts the task, with the awaiting coroutine as its continuation. Symmetric transfer avoids growing the stack on long chains. */
+		inline std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+			_handle.promise()._continuation = awaiting;
+			return _handle;
+		}
+
+		inline T await_resume() {
+			return _handle.promise().takeResult();
+		}
+
+	private:
+		Handle _handle;
+	};
+
+	template<typename T>
+	inline Task<T> TaskPromise<T>::get_return_object() noexcept {
+		return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+	}
+
+	inline Task<void> TaskPromise<void>::get_return_object() noexcept {
+		return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+	}
+}
+#endif
\ No newline at end of file
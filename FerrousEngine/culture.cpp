@@ -13,46 +13,89 @@ namespace fe {
 		NumberFormat.DecimalPoint = U'.';
 		NumberFormat.NegativeSign = U'-';
 		NumberFormat.PositiveSign = U'+';
+		NumberFormat.MultiplySign = U'*';
 		NumberFormat.PercentSymbol = U'%';
 		NumberFormat.EqualSymbol = U'=';
+		NumberFormat.GroupSize = 3;
 		TextFormat.ListSeparator = ',';
 		TextFormat.Direction = TextFlowDirection::LeftToRight;
-		TextFormat.toLower = &defaultLatinToLower;
-		TextFormat.toUpper = &defaultLatinToUpper;
-		TextFormat.isSpace = &defaultLatinIsSpace;
-		TextFormat.isWhitespace = &defaultLatinIsWhitespace;
+		TextFormat.toLower = &defaultToLower;
+		TextFormat.toUpper = &defaultToUpper;
+		TextFormat.isSpace = &defaultIsSpace;
+		TextFormat.isWhitespace = &defaultIsWhitespace;
 	}
 
-	char32_t CultureInfo::defaultLatinToLower(const char32_t& c) {
-		if (c >= 65 && c <= 90)
-			return c + 32;
+	char32_t CultureInfo::defaultToLower(const char32_t& c) {
+		return Unicode::toLower(c);
+	}
+
+	char32_t CultureInfo::defaultToUpper(const char32_t& c) {
+		return Unicode::toUpper(c);
+	}
 
-		return c;
+	bool CultureInfo::defaultIsSpace(const char32_t& c) {
+		return Unicode::isSpace(c);
 	}
 
-	char32_t CultureInfo::defaultLatinToUpper(const char32_t& c) {
-		if (c >= 97 && c <= 122)
-			return c - 32;
+	bool CultureInfo::defaultIsWhitespace(const char32_t& c) {
+		return Unicode::isWhitespace(c);
+	}
 
-		return c;
+	SortKey::SortKey() {
+		_data = nullptr;
+		_num_bytes = 0;
+		_allocator = nullptr;
 	}
 
-	bool CultureInfo::defaultLatinIsSpace(const char32_t& c) {
-		return c == 32;
+	SortKey::SortKey(uint8_t* data, uint32_t numBytes, FerrousAllocator* allocator) {
+		_data = data;
+		_num_bytes = numBytes;
+		_allocator = allocator;
+	}
+
+	SortKey::SortKey(const SortKey& copy) {
+		_data = copy._data;
+		_num_bytes = copy._num_bytes;
+		_allocator = copy._allocator;
+
+		if (_data != nullptr)
+			_allocator->ref(_data);
 	}
 
-	bool CultureInfo::defaultLatinIsWhitespace(const char32_t& c) {
-		return c == U' ' || c==U'\t' || c==U'\n' || c==U'\r';
+	SortKey::~SortKey() {
+		if (_data != nullptr)
+			_allocator->deref(_data);
 	}
 
-	Culture::Culture() : _info() {
-		_strings = Dictionary<FeString, FeString>();
+	SortKey& SortKey::operator=(const SortKey& other) {
+		if (this != &other) {
+			if (_data != nullptr)
+				_allocator->deref(_data);
+
+			_data = other._data;
+			_num_bytes = other._num_bytes;
+			_allocator = other._allocator;
+
+			if (_data != nullptr)
+				_allocator->ref(_data);
+		}
+
+		return *this;
 	}
 
-	Culture::Culture(const CultureInfo& info, FerrousAllocator* allocator) : _info(info) {
-		_strings = Dictionary<FeString, FeString>();
+	int32_t SortKey::compare(const SortKey& other) const {
+		uint32_t len = min(_num_bytes, other._num_bytes);
+		int result = len > 0 ? memcmp(_data, other._data, len) : 0;
+		if (result != 0)
+			return result;
+
+		return _num_bytes == other._num_bytes ? 0 : (_num_bytes < other._num_bytes ? -1 : 1);
 	}
 
+	Culture::Culture() : _info(), _strings() { }
+
+	Culture::Culture(const CultureInfo& info, FerrousAllocator* allocator) : _info(info), _strings(0, allocator) { }
+
 	const FeString& Culture::displayName() const {
 		return _info.DisplayName;
 	}
@@ -69,6 +112,65 @@ namespace fe {
 		return _info.TextFormat.toUpper(character);
 	}
 
+	void Culture::toLower(const char32_t* src, char32_t* dest, uint32_t count) const {
+		char32_t(*func)(const char32_t&) = _info.TextFormat.toLower;
+
+		// Skip the per-character function pointer when the culture uses the default Unicode mapping.
+		if (func == &CultureInfo::defaultToLower) {
+			Unicode::toLower(src, dest, count);
+		}
+		else {
+			for (uint32_t i = 0; i < count; i++)
+				dest[i] = func(src[i]);
+		}
+	}
+
+	void Culture::toUpper(const char32_t* src, char32_t* dest, uint32_t count) const {
+		char32_t(*func)(const char32_t&) = _info.TextFormat.toUpper;
+
+		if (func == &CultureInfo::defaultToUpper) {
+			Unicode::toUpper(src, dest, count);
+		}
+		else {
+			for (uint32_t i = 0; i < count; i++)
+				dest[i] = func(src[i]);
+		}
+	}
+
+	SortKey Culture::getSortKey(const FeString& str, FerrousAllocator* allocator) const {
+		// Level 1: the case-folded characters, as 3-byte big-endian weights offset by 1, so they always sort after the level separator.
+		// Level 2: 1 byte per character, which is 1 if the character was changed by folding (i.e. upper-case), or 0 otherwise.
+		const uint32_t len = str.len();
+		const char32_t* src = str.getData();
+		uint32_t numBytes = (len * 4) + 3;
+		uint8_t* mem = allocator->allocType<uint8_t>(numBytes);
+		char32_t* folded = allocator->allocType<char32_t>(len > 0 ? len : 1);
+
+		// Fold in batches through the culture, so its default Unicode tables and ASCII fast-path are used.
+		toUpper(src, folded, len);
+		toLower(folded, folded, len);
+
+		uint8_t* primary = mem;
+		uint8_t* secondary = mem + (len * 3) + 3;
+
+		for (uint32_t i = 0; i < len; i++) {
+			uint32_t weight = min(folded[i], Unicode::MAX_CODEPOINT) + 1;
+			primary[0] = (weight >> 16) & 0xFF;
+			primary[1] = (weight >> 8) & 0xFF;
+			primary[2] = weight & 0xFF;
+			primary += 3;
+
+			secondary[i] = folded[i] != src[i] ? 1 : 0;
+		}
+
+		primary[0] = 0;
+		primary[1] = 0;
+		primary[2] = 0;
+
+		allocator->dealloc(folded);
+		return SortKey(mem, numBytes, allocator);
+	}
+
 	bool Culture::isSpace(const char32_t& character) const {
 		return _info.TextFormat.isSpace(character);
 	}
@@ -1,7 +1,8 @@
 #pragma once
 #include "strings.h"
 #include "allocation.h"
-#include "dictionary.h"
+#include "flat_map.h"
+#include "unicode.h"
 
 using namespace fe::collections;
 
@@ -88,10 +89,43 @@ namespace fe {
 		}
 
 	private:
-		static char32_t defaultLatinToLower(const char32_t& c);
-		static char32_t defaultLatinToUpper(const char32_t& c);
-		static bool defaultLatinIsSpace(const char32_t& c);
-		static bool defaultLatinIsWhitespace(const char32_t& c);
+		friend class Culture;
+
+		/* Culture-invariant defaults, which use the Unicode tables. */
+		static char32_t defaultToLower(const char32_t& c);
+		static char32_t defaultToUpper(const char32_t& c);
+		static bool defaultIsSpace(const char32_t& c);
+		static bool defaultIsWhitespace(const char32_t& c);
+	};
+
+	/*	A binary collation key for a string, generated once by Culture::getSortKey().
+		Comparing two sort keys gives the same order as a culture-aware comparison of the strings they were generated from,
+		but only needs a memcmp. Useful when the same strings are compared many times, such as when sorting. */
+	class SortKey {
+	public:
+		SortKey();
+		SortKey(const SortKey& copy);
+		~SortKey();
+
+		/* Returns less than 0 if the current key comes first, 0 if both are equal, or more than 0 if the other key comes first. */
+		int32_t compare(const SortKey& other) const;
+
+		inline const uint8_t* getData() const { return _data; }
+		inline uint32_t byteLen() const { return _num_bytes; }
+
+		SortKey& operator=(const SortKey& other);
+
+		inline bool operator<(const SortKey& other) const { return compare(other) < 0; }
+		inline bool operator==(const SortKey& other) const { return compare(other) == 0; }
+
+	private:
+		friend class Culture;
+
+		SortKey(uint8_t* data, uint32_t numBytes, FerrousAllocator* allocator);
+
+		uint8_t* _data;
+		uint32_t _num_bytes;
+		FerrousAllocator* _allocator;
 	};
 
 	class Culture {
@@ -110,6 +144,16 @@ namespace fe {
 
 		char32_t toUpper(const char32_t& character) const;
 
+		/* Converts count characters from src to lower-case and stores them in dest. src and dest may be the same. */
+		void toLower(const char32_t* src, char32_t* dest, uint32_t count) const;
+
+		/* Converts count characters from src to upper-case and stores them in dest. src and dest may be the same. */
+		void toUpper(const char32_t* src, char32_t* dest, uint32_t count) const;
+
+		/*	Generates a sort key for a string. Strings are ordered by their case-insensitive characters first,
+			then by case, with lower-case first. e.g. "apple" < "Apple" < "apricot". */
+		SortKey getSortKey(const FeString& str, FerrousAllocator* allocator = Memory::get()) const;
+
 		bool isSpace(const char32_t& character) const;
 
 		bool isWhitespace(const char32_t& character) const;
@@ -122,7 +166,8 @@ namespace fe {
 		/* The character used when separating items in a list. */
 		char32_t listSeparator() const;
 
-		inline const FeString& operator[] (const FeString& key) {
+		/* Gets a localized string. Accepts an FeString, FeStringView or U"literal" key, none of which allocate during the lookup. */
+		inline const FeString& operator[] (const FeStringView& key) {
 			return _strings[key];
 		}
 
@@ -141,6 +186,6 @@ namespace fe {
 		Culture(const CultureInfo& info, FerrousAllocator* allocator = Memory::get());
 
 		const CultureInfo _info;
-		Dictionary<FeString, FeString> _strings;
+		FlatMap<FeString, FeString> _strings;	/* Loaded once, then only read. */
 	};
 }
\ No newline at end of file
@@ -0,0 +1,334 @@
+#pragma once
+#include "allocation.h"
+#include "exceptions.h"
+#include <iterator>
+
+namespace fe {
+	namespace collections {
+		/*	A double-ended queue. Items are stored in fixed-size chunks, each filling one Memory page, and found through a ring of chunk
+			pointers. Adding or removing at either end is O(1) and never moves other items, so pointers to items stay valid until
+			the item is removed. One emptied chunk is kept spare, so a queue which hovers around a chunk boundary does not reallocate. */
+		template<typename T>
+		class Deque {
+			static constexpr uint32_t getChunkItems() {
+				// Memory::alloc() reserves room for alignment within the page, on top of the requested size.
+				size_t bytes = Memory::PAGE_FREE_SIZE - alignof(T) - 1;
+				return sizeof(T) >= bytes ? 1 : (uint32_t)(bytes / sizeof(T));
+			}
+
+		public:
+			/* The number of items per chunk, chosen so that a chunk fills one Memory page. */
+			static constexpr uint32_t CHUNK_ITEMS = getChunkItems();
+
+			template<bool IsConst>
+			class Iterator {
+				using Owner = std::conditional_t<IsConst, const Deque, Deque>;
+
+			public:
+				using value_type = T;
+				using reference = std::conditional_t<IsConst, const T&, T&>;
+				using pointer = std::conditional_t<IsConst, const T*, T*>;
+				using difference_type = std::ptrdiff_t;
+				using iterator_category = std::bidirectional_iterator_tag;
+
+				Iterator(Owner* owner, uint32_t index) : _owner(owner), _index(index) { }
+
+				inline reference operator*() const { return *_owner->getItem(_index); }
+				inline pointer operator->() const { return _owner->getItem(_index); }
+
+				inline Iterator& operator++() {
+					_index++;
+					return *this;
+				}
+
+				inline Iterator& operator--() {
+					_index--;
+					return *this;
+				}
+
+				inline bool operator ==(const Iterator& other) const { return _index == other._index; }
+				inline bool operator !=(const Iterator& other) const { return _index != other._index; }
+
+			private:
+				Owner* _owner;
+				uint32_t _index;
+			};
+
+			using iterator = Iterator<false>;
+			using const_iterator = Iterator<true>;
+
+			/* Creates an empty deque. Memory is not allocated until the first item is added. */
+			Deque(FerrousAllocator* allocator = Memory::get()) {
+				_chunks = nullptr;
+				_spareChunk = nullptr;
+				_mapCapacity = 0;
+				_firstChunk = 0;
+				_chunkCount = 0;
+				_start = 0;
+				_count = 0;
+				_allocator = allocator;
+			}
+
+			Deque(const Deque& other) : Deque(other._allocator) {
+				for (const T& item : other)
+					pushBack(item);
+			}
+
+			Deque(Deque&& other) noexcept {
+				takeFrom(other);
+			}
+
+			~Deque() {
+				release();
+			}
+
+			Deque& operator=(const Deque& other) {
+				if (this != &other) {
+					clear();
+					for (const T& item : other)
+						pushBack(item);
+				}
+
+				return *this;
+			}
+
+			Deque& operator=(Deque&& other) noexcept {
+				if (this != &other) {
+					release();
+					takeFrom(other);
+				}
+
+				return *this;
+			}
+
+			inline iterator begin() { return iterator(this, 0); }
+			inline iterator end() { return iterator(this, _count); }
+			inline const_iterator begin() const { return const_iterator(this, 0); }
+			inline const_iterator end() const { return const_iterator(this, _count); }
+
+			inline void pushBack(const T& item) { emplaceBack(item); }
+			inline void pushBack(T&& item) { emplaceBack(std::move(item)); }
+			inline void pushFront(const T& item) { emplaceFront(item); }
+			inline void pushFront(T&& item) { emplaceFront(std::move(item)); }
+
+			template<typename... Args>
+			T& emplaceBack(Args&&... args) {
+				// Construct the item first, in case the arguments refer to an item in the deque.
+				T item(std::forward<Args>(args)...);
+				uint32_t position = _start + _count;
+
+				if (position == _chunkCount * CHUNK_ITEMS)
+					addChunk(false);
+
+				T* slot = getSlot(position);
+				new (slot) T(std::move(item));
+				_count++;
+				return *slot;
+			}
+
+			template<typename... Args>
+			T& emplaceFront(Args&&... args) {
+				T item(std::forward<Args>(args)...);
+
+				if (_start == 0) {
+					addChunk(true);
+					_start = CHUNK_ITEMS;
+				}
+
+				T* slot = getSlot(_start - 1);
+				new (slot) T(std::move(item));
+				_start--;
+				_count++;
+				return *slot;
+			}
+
+			/* Removes and returns the first item. */
+			T popFront() {
+				if (_count == 0)
+					throw IndexOutOfRangeExeption(0, 0);
+
+				T* slot = getSlot(_start);
+				T item(std::move(*slot));
+				slot->~T();
+				_start++;
+				_count--;
+
+				if (_start == CHUNK_ITEMS) {
+					releaseChunk(_chunks[_firstChunk]);
+					_firstChunk = (_firstChunk + 1) & (_mapCapacity - 1);
+					_chunkCount--;
+					_start = 0;
+				}
+
+				return item;
+			}
+
+			/* Removes and returns the last item. */
+			T popBack() {
+				if (_count == 0)
+					throw IndexOutOfRangeExeption(0, 0);
+
+				_count--;
+				uint32_t end = _start + _count;
+				T* slot = getSlot(end);
+				T item(std::move(*slot));
+				slot->~T();
+
+				// Release the last chunk once nothing is left in it.
+				if (_chunkCount > 1 && end <= (_chunkCount - 1) * CHUNK_ITEMS) {
+					releaseChunk(_chunks[(_firstChunk + _chunkCount - 1) & (_mapCapacity - 1)]);
+					_chunkCount--;
+				}
+
+				return item;
+			}
+
+			/* Removes the first item into item. Returns false if the deque is empty. */
+			inline bool tryPopFront(T& item) {
+				if (_count == 0)
+					return false;
+
+				item = popFront();
+				return true;
+			}
+
+			/* Removes the last item into item. Returns false if the deque is empty. */
+			inline bool tryPopBack(T& item) {
+				if (_count == 0)
+					return false;
+
+				item = popBack();
+				return true;
+			}
+
+			inline T& front() { return (*this)[0]; }
+			inline const T& front() const { return (*this)[0]; }
+			inline T& back() { return (*this)[_count - 1]; }
+			inline const T& back() const { return (*this)[_count - 1]; }
+
+			/* Destroys every item, and releases every chunk. */
+			void clear() {
+				for (uint32_t i = 0; i < _count; i++)
+					getItem(i)->~T();
+
+				for (uint32_t i = 0; i < _chunkCount; i++)
+					releaseChunk(_chunks[(_firstChunk + i) & (_mapCapacity - 1)]);
+
+				_firstChunk = 0;
+				_chunkCount = 0;
+				_start = 0;
+				_count = 0;
+			}
+
+			inline uint32_t count() const { return _count; }
+			inline bool isEmpty() const { return _count == 0; }
+
+			inline T& operator[] (uint32_t index) {
+				if (index >= _count)
+					throw IndexOutOfRangeExeption(index, _count);
+
+				return *getItem(index);
+			}
+
+			inline const T& operator[] (uint32_t index) const {
+				if (index >= _count)
+					throw IndexOutOfRangeExeption(index, _count);
+
+				return *getItem(index);
+			}
+
+		private:
+			T** _chunks;			/* Ring of chunk pointers. Its capacity is 0 or a power of two. */
+			T* _spareChunk;
+			uint32_t _mapCapacity;
+			uint32_t _firstChunk;	/* Ring index of the chunk holding the first item. */
+			uint32_t _chunkCount;
+			uint32_t _start;		/* Index of the first item within the first chunk. */
+			uint32_t _count;
+			FerrousAllocator* _allocator;
+
+			/* Returns the slot at the specified position, counted from the start of the first chunk. */
+			inline T* getSlot(uint32_t position) const {
+				return _chunks[(_firstChunk + position / CHUNK_ITEMS) & (_mapCapacity - 1)] + (position % CHUNK_ITEMS);
+			}
+
+			inline T* getItem(uint32_t index) const {
+				return getSlot(_start + index);
+			}
+
+			/* Adds an empty chunk before the first chunk, or after the last one, growing the ring of chunk pointers if it is full. */
+			void addChunk(bool atFront) {
+				if (_chunkCount == _mapCapacity) {
+					uint32_t newCapacity = _mapCapacity > 0 ? _mapCapacity * 2 : 4;
+					T** newChunks = _allocator->allocType<T*>(newCapacity);
+					for (uint32_t i = 0; i < _chunkCount; i++)
+						newChunks[i] = _chunks[(_firstChunk + i) & (_mapCapacity - 1)];
+
+					if (_chunks != nullptr)
+						_allocator->dealloc(_chunks);
+
+					_chunks = newChunks;
+					_mapCapacity = newCapacity;
+					_firstChunk = 0;
+				}
+
+				T* chunk = _spareChunk;
+				if (chunk != nullptr)
+					_spareChunk = nullptr;
+				else
+					chunk = static_cast<T*>(_allocator->alloc(sizeof(T) * CHUNK_ITEMS, alignof(T)));
+
+				if (atFront) {
+					_firstChunk = (_firstChunk - 1) & (_mapCapacity - 1);
+					_chunks[_firstChunk] = chunk;
+				}
+				else {
+					_chunks[(_firstChunk + _chunkCount) & (_mapCapacity - 1)] = chunk;
+				}
+
+				_chunkCount++;
+			}
+
+			/* Keeps the chunk as the spare, or frees it if there already is one. */
+			inline void releaseChunk(T* chunk) {
+				if (_spareChunk == nullptr)
+					_spareChunk = chunk;
+				else
+					_allocator->dealloc(chunk);
+			}
+
+			void takeFrom(Deque& other) {
+				_chunks = other._chunks;
+				_spareChunk = other._spareChunk;
+				_mapCapacity = other._mapCapacity;
+				_firstChunk = other._firstChunk;
+				_chunkCount = other._chunkCount;
+				_start = other._start;
+				_count = other._count;
+				_allocator = other._allocator;
+
+				other._chunks = nullptr;
+				other._spareChunk = nullptr;
+				other._mapCapacity = 0;
+				other._firstChunk = 0;
+				other._chunkCount = 0;
+				other._start = 0;
+				other._count = 0;
+			}
+
+			void release() {
+				clear();
+
+				if (_spareChunk != nullptr)
+					_allocator->dealloc(_spareChunk);
+
+				if (_chunks != nullptr)
+					_allocator->dealloc(_chunks);
+
+				_spareChunk = nullptr;
+				_chunks = nullptr;
+				_mapCapacity = 0;
+			}
+		};
+	}
+}
\ No newline at end of file
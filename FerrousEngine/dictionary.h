@@ -1,212 +1,526 @@
 #pragma once
 #include "key_value_pair.h"
 #include "collection.h"
+#include "allocation.h"
+#include "bits.h"
+#include "hash.h"
+#include <utility>
+#include <type_traits>
 
 namespace fe {
 	namespace collections {
-		template <typename K, typename V>
-		struct Bucket {
-		public:
-			// Next bucket with the same key
-			Bucket<K,V>* next;
-			V value;
+		/*	A group of control bytes which are probed together. With SSE2, a whole group is matched against a hash in a single compare.
+			Each control byte is either EMPTY, DELETED, or the low 7 bits of the hash of the key in its slot (always positive). */
+		struct HashControlGroup {
+			static constexpr uint32_t WIDTH = 16;
+			static constexpr int8_t EMPTY = -128;
+			static constexpr int8_t DELETED = -2;
+
+			explicit HashControlGroup(const int8_t* ctrl) {
+#ifdef FE_SSE2
+				_ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl));
+#else
+				memcpy(_ctrl, ctrl, WIDTH);
+#endif
+			}
+
+			/* Returns a bit mask of the slots in the group which have the provided control byte. */
+			inline uint32_t match(const int8_t h2) const {
+#ifdef FE_SSE2
+				return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_ctrl, _mm_set1_epi8(h2)));
+#else
+				uint32_t mask = 0;
+				for (uint32_t i = 0; i < WIDTH; i++)
+					mask |= (uint32_t)(_ctrl[i] == h2) << i;
+
+				return mask;
+#endif
+			}
 
-			Bucket(const K& key, const V& value) :
-				_key(key), value(value), next(nullptr) {
+			inline uint32_t matchEmpty() const {
+				return match(EMPTY);
 			}
 
-			const K& getKey() const {
-				return _key;
+			/* Returns a bit mask of the slots in the group which do not contain an entry. Both EMPTY and DELETED have their sign bit set. */
+			inline uint32_t matchEmptyOrDeleted() const {
+#ifdef FE_SSE2
+				return (uint32_t)_mm_movemask_epi8(_ctrl);
+#else
+				uint32_t mask = 0;
+				for (uint32_t i = 0; i < WIDTH; i++)
+					mask |= (uint32_t)(_ctrl[i] < 0) << i;
+
+				return mask;
+#endif
 			}
 
 		private:
-			K _key;
+#ifdef FE_SSE2
+			__m128i _ctrl;
+#else
+			int8_t _ctrl[WIDTH];
+#endif
 		};
 
-		/* Default hash function class */
-		template <typename K>
-		struct DefaultKeyHash {
-			uint64_t operator()(const K& key, const uint32_t tableSize) const
-			{
-				return reinterpret_cast<const uint64_t&>(key) % tableSize;
-			}
-		};
+		/*	Open-addressing hash map. Entries are stored inline in a flat slot array, alongside one control byte per slot.
+			Lookups probe a whole group of control bytes at a time, so a key is usually found with a single group compare and one key comparison.
+			The table grows automatically when the number of entries (including deleted ones) would exceed the maximum load factor.
 
-		/* HashID map class template */
-		template <typename K, typename V, typename F = DefaultKeyHash<K>>
+			F must return a well-distributed 64-bit hash of a key, since the table size is a power of two and a hash is reduced by masking. See: DefaultKeyHash. */
+		template <typename K, typename V, typename F = DefaultKeyHash<K>, typename E = DefaultKeyEquals<K>>
 		class Dictionary {
+			template <typename H, typename C, typename = void>
+			struct IsTransparent : std::false_type {};
+
+			template <typename H, typename C>
+			struct IsTransparent<H, C, std::void_t<typename H::is_transparent, typename C::is_transparent>> : std::true_type {};
+
+			template <typename Q>
+			using EnableLookup = std::enable_if_t<IsTransparent<F, E>::value || std::is_same<Q, PrehashedKey<K>>::value>;
+
 		public:
-			Dictionary(uint32_t tableSize = 4, FerrousAllocator* allocator = Memory::get()) {
-				_tableSize = tableSize;
+			static constexpr float DEFAULT_MAX_LOAD_FACTOR = 0.875f;
+
+			/* Creates a new dictionary. Memory is not allocated until the first entry is added, unless an initial capacity is provided. */
+			Dictionary(uint32_t initialCapacity = 0, FerrousAllocator* allocator = Memory::get(), float maxLoadFactor = DEFAULT_MAX_LOAD_FACTOR) {
+				assert(maxLoadFactor > 0.0f && maxLoadFactor < 1.0f);
+
+				_ctrl = nullptr;
+				_slots = nullptr;
+				_capacity = 0;
+				_count = 0;
+				_growthLeft = 0;
+				_maxLoadFactor = maxLoadFactor;
 				_allocator = allocator;
-				_table = _allocator->allocType<Bucket<K, V>*>(_tableSize);
-				Memory::ZeroType<Bucket<K,V>*>(_table, _tableSize);
+
+				if (initialCapacity > 0)
+					ensureCapacity(initialCapacity);
+			}
+
+			Dictionary(const Dictionary& other) :
+				Dictionary(0, other._allocator, other._maxLoadFactor) {
+				copyFrom(other);
+			}
+
+			Dictionary(Dictionary&& other) noexcept {
+				takeFrom(other);
 			}
 
 			~Dictionary() {
 				destroyTable();
 			}
 
-			bool containsKey(const K& key) {
-				HashID hashValue = _hashFunc(key, _tableSize);
-				Bucket<K, V>* entry = _table[hashValue];
+			Dictionary& operator=(const Dictionary& other) {
+				if (this != &other) {
+					clear();
+					copyFrom(other);
+				}
 
-				while (entry != nullptr) {
-					if (entry->getKey() == key)
-						return true;
+				return *this;
+			}
 
-					entry = entry->next;
+			Dictionary& operator=(Dictionary&& other) noexcept {
+				if (this != &other) {
+					destroyTable();
+					takeFrom(other);
 				}
 
-				return false;
+				return *this;
 			}
 
-			V get(const K& key) {
-				HashID hashValue = _hashFunc(key, _tableSize);
-				uint32_t bucketID = hashValue % _tableSize;
-				Bucket<K, V>* entry = _table[bucketID];
+			bool containsKey(const K& key) const {
+				return find(key) != NOT_FOUND;
+			}
 
-				while (entry != nullptr) {
-					if (entry->getKey() == key) 
-						return entry->value;
+			/*	Transparent lookup. Accepts a PrehashedKey<K>, or any type accepted by both F and E if they define is_transparent.
+				e.g. A Dictionary<FeString, V> can be queried with a FeStringView or a U"literal", without constructing a FeString. */
+			template <typename Q, typename = EnableLookup<Q>>
+			bool containsKey(const Q& key) const {
+				return find(key) != NOT_FOUND;
+			}
 
-					entry = entry->next;
-				}
+			V get(const K& key) const {
+				return getValue(key);
+			}
 
-				throw "Key not found.";
+			template <typename Q, typename = EnableLookup<Q>>
+			V get(const Q& key) const {
+				return getValue(key);
 			}
 
-			bool tryGet(const K& key, V& value) {
-				HashID hashValue = _hashFunc(key, _tableSize);
-				uint32_t bucketID = hashValue % _tableSize;
-				Bucket<K, V>* entry = _table[bucketID];
+			bool tryGet(const K& key, V& value) const {
+				return tryGetValue(key, value);
+			}
 
-				while (entry != nullptr) {
-					if (entry->getKey() == key) {
-						value = entry->value;
-						return true;
-					}
-					entry = entry->next;
-				}
-				return false;
+			template <typename Q, typename = EnableLookup<Q>>
+			bool tryGet(const Q& key, V& value) const {
+				return tryGetValue(key, value);
 			}
 
+			/* Adds an entry, or updates the value of an existing entry with the same key. */
 			void put(const K& key, const V& value) {
-				HashID hashValue = _hashFunc(key, _tableSize);
-				uint32_t bucketID = hashValue % _tableSize;
-				Bucket<K, V>* prev = nullptr;
-				Bucket<K, V>* entry = _table[bucketID];
+				uint64_t hash = _hashFunc(key);
+				uint32_t index = find(key, hash);
 
-				while (entry != nullptr && !(entry->getKey() == key)) {
-					prev = entry;
-					entry = entry->next;
-				}
-
-				if (entry == nullptr) {
-					entry = _allocator->allocType<Bucket<K, V>>();
-					new (entry) Bucket<K, V>(key, value);
-
-					if (prev == nullptr)
-						_table[bucketID] = entry; // insert as first entry in bucket.
-					else
-						prev->next = entry;
+				if (index == NOT_FOUND) {
+					index = prepareInsert(hash);
+					new (&_slots[index]) KeyValuePair<K, V>{ key, value };
 				}
 				else {
 					// just update the value
-					entry->value = value;
+					_slots[index].Value = value;
 				}
 			}
 
 			bool remove(const K& key) {
-				HashID hashValue = _hashFunc(key, _tableSize);
-				uint32_t bucketID = hashValue % _tableSize;
-				Bucket<K, V>* prev = nullptr;
-				Bucket<K, V>* entry = _table[bucketID];
-
-				while (entry != nullptr ) {
-					// Delete entry if key found.
-					if (entry->getKey() == key) {
-						if (prev == nullptr)
-							_table[bucketID] = entry->next;
-						else
-							prev->next = entry->next;
-
-						_allocator->dealloc(entry);
-						return true;
-					}
-
-					prev = entry;
-					entry = entry->next;
-				}
+				return removeKey(key);
+			}
 
-				return false;
+			template <typename Q, typename = EnableLookup<Q>>
+			bool remove(const Q& key) {
+				return removeKey(key);
 			}
 
-			void ensureCapacity(uint32_t capacity) {
-				if (_tableSize >= capacity)
+			/* Removes all entries. The table keeps its current capacity. */
+			void clear() {
+				if (_capacity == 0)
 					return;
 
-				uint32_t newSize = _tableSize * 2;
-				if (newSize < capacity)
-					newSize = capacity;
+				destroySlots();
+				memset(_ctrl, HashControlGroup::EMPTY, _capacity + HashControlGroup::WIDTH);
+				_count = 0;
+				_growthLeft = getMaxEntries(_capacity);
+			}
 
-				Bucket<K, V>* newTable = _allocator->allocType<Bucket<K, V>*>(newSize);
+			/* Ensures the dictionary can hold at least the specified number of entries without rehashing. */
+			void ensureCapacity(uint32_t capacity) {
+				uint32_t required = getCapacityFor(capacity);
+				if (required > _capacity)
+					resize(required);
+			}
 
-				// Iterate over all buckets in old table and put them into the new one.
-				for (uint32_t i = 0; i < _tableSize; i++) {
-					Bucket<K, V>* entry = _table[i];
-					K key = entry->getKey();
-					HashID hashValue = _hashFunc(key, newSize);
-					uint32_t bucketID = hashValue % newSize;
+			/* Sets the maximum ratio of occupied slots to capacity. Lower values use more memory but shorten probe sequences. */
+			void setMaxLoadFactor(float maxLoadFactor) {
+				assert(maxLoadFactor > 0.0f && maxLoadFactor < 1.0f);
+				_maxLoadFactor = maxLoadFactor;
 
-					// Put the bucket into the new table
-					newTable[bucketID] = entry;
+				if (_capacity > 0) {
+					uint32_t required = getCapacityFor(_count);
+					resize(required > _capacity ? required : _capacity);
 				}
+			}
 
-				// Destroy old table and store new one.
-				destroyTable();
-				_tableSize = newSize;
-				_table = newTable;
+			inline float maxLoadFactor() const {
+				return _maxLoadFactor;
 			}
 
-			inline V& operator[] (const K& key) {
-				HashID hashValue = _hashFunc(key, _tableSize);
-				uint32_t bucketID = hashValue % _tableSize;
-				Bucket<K, V>* entry = _table[bucketID];
+			/* Gets the number of entries in the dictionary. */
+			inline uint32_t count() const {
+				return _count;
+			}
 
-				while (entry != nullptr) {
-					if (entry->getKey() == key)
-						return entry->value;
+			/* Gets the number of slots in the table. Always 0 or a power of two. */
+			inline uint32_t capacity() const {
+				return _capacity;
+			}
 
-					entry = entry->next;
-				}
+			inline V& operator[] (const K& key) {
+				return getValueRef(key);
+			}
 
-				throw "Key not found.";
+			template <typename Q, typename = EnableLookup<Q>>
+			inline V& operator[] (const Q& key) {
+				return getValueRef(key);
 			}
 
 		private:
-			typedef uint64_t HashID;
-
-			// hash table
-			Bucket<K, V>** _table;
-			uint32_t _tableSize;
+			static constexpr uint32_t NOT_FOUND = UINT32_MAX;
+			static constexpr uint32_t MIN_CAPACITY = HashControlGroup::WIDTH;
+
+			/*	Control bytes, followed by a copy of the first group so that a group can be loaded from any slot without wrapping.
+				Slots are only constructed while their control byte is full. */
+			int8_t* _ctrl;
+			KeyValuePair<K, V>* _slots;
+			uint32_t _capacity;
+			uint32_t _count;
+			uint32_t _growthLeft; /* Number of EMPTY slots which can be filled before the table must be rehashed. */
+			float _maxLoadFactor;
 			FerrousAllocator* _allocator;
 			F _hashFunc;
+			E _equals;
 
-			void destroyTable() {
-				// Deallocate nodes
-				for (uint32_t i = 0; i < _tableSize; i++) {
-					Bucket<K, V>* node = _table[i];
-					while (node != nullptr) {
-						Bucket<K, V>* prev = node;
-						node = node->next;
-						_allocator->dealloc(prev);
+			/* The upper bits pick the first group to probe. The lowest 7 bits are stored in the control byte. */
+			static inline uint32_t getH1(const uint64_t hash) {
+				return (uint32_t)(hash >> 7);
+			}
+
+			static inline int8_t getH2(const uint64_t hash) {
+				return (int8_t)(hash & 0x7F);
+			}
+
+			inline uint32_t getMaxEntries(const uint32_t capacity) const {
+				uint32_t maxEntries = (uint32_t)(capacity * _maxLoadFactor);
+				if (maxEntries == 0)
+					return 1; // A very low load factor must still let the table grow, rather than leave no room at all.
+
+				return maxEntries < capacity ? maxEntries : capacity - 1; // There must always be an empty slot to end a probe sequence.
+			}
+
+			/* Gets the smallest capacity which can hold the provided number of entries. */
+			uint32_t getCapacityFor(const uint32_t numEntries) const {
+				uint32_t capacity = MIN_CAPACITY;
+				while (getMaxEntries(capacity) < numEntries)
+					capacity *= 2;
+
+				return capacity;
+			}
+
+			inline void setCtrl(const uint32_t index, const int8_t value) {
+				_ctrl[index] = value;
+
+				// Keep the copy of the first group in sync.
+				if (index < HashControlGroup::WIDTH)
+					_ctrl[_capacity + index] = value;
+			}
+
+			template <typename Q>
+			inline uint64_t hashOf(const Q& key) const {
+				return _hashFunc(key);
+			}
+
+			template <typename Q>
+			inline uint64_t hashOf(const PrehashedKey<Q>& key) const {
+				return key.hash;
+			}
+
+			template <typename Q>
+			inline bool keyEquals(const K& a, const Q& b) const {
+				return _equals(a, b);
+			}
+
+			template <typename Q>
+			inline bool keyEquals(const K& a, const PrehashedKey<Q>& b) const {
+				return _equals(a, b.key);
+			}
+
+			template <typename Q>
+			inline uint32_t find(const Q& key) const {
+				return _count > 0 ? find(key, hashOf(key)) : NOT_FOUND;
+			}
+
+			/*	Probes groups using triangular steps (1, 2, 3... groups), which visits every group of a power-of-two table exactly once.
+				Probing stops at the first group containing an empty slot, since the key would have been inserted there. */
+			template <typename Q>
+			uint32_t find(const Q& key, const uint64_t hash) const {
+				if (_capacity == 0)
+					return NOT_FOUND;
+
+				uint32_t mask = _capacity - 1;
+				uint32_t pos = getH1(hash) & mask;
+				uint32_t step = 0;
+				int8_t h2 = getH2(hash);
+
+				while (true) {
+					HashControlGroup group(&_ctrl[pos]);
+
+					for (uint32_t matches = group.match(h2); matches != 0; matches &= matches - 1) {
+						uint32_t index = (pos + Bits::countTrailingZeros(matches)) & mask;
+						if (keyEquals(_slots[index].Key, key))
+							return index;
 					}
 
-					_table[i] = nullptr;
+					if (group.matchEmpty() != 0)
+						return NOT_FOUND;
+
+					step += HashControlGroup::WIDTH;
+					pos = (pos + step) & mask;
+				}
+			}
+
+			template <typename Q>
+			V getValue(const Q& key) const {
+				uint32_t index = find(key);
+				if (index == NOT_FOUND)
+					throw "Key not found.";
+
+				return _slots[index].Value;
+			}
+
+			template <typename Q>
+			V& getValueRef(const Q& key) {
+				uint32_t index = find(key);
+				if (index == NOT_FOUND)
+					throw "Key not found.";
+
+				return _slots[index].Value;
+			}
+
+			template <typename Q>
+			bool tryGetValue(const Q& key, V& value) const {
+				uint32_t index = find(key);
+				if (index == NOT_FOUND)
+					return false;
+
+				value = _slots[index].Value;
+				return true;
+			}
+
+			template <typename Q>
+			bool removeKey(const Q& key) {
+				uint32_t index = find(key);
+				if (index == NOT_FOUND)
+					return false;
+
+				_slots[index].~KeyValuePair<K, V>();
+				_count--;
+
+				// If every group which contains the slot also contains an empty slot, no probe sequence can have continued past it.
+				// It can then be marked as empty instead of deleted, so it does not count against the load factor.
+				uint32_t mask = _capacity - 1;
+				uint32_t emptyBefore = HashControlGroup(&_ctrl[(index - HashControlGroup::WIDTH) & mask]).matchEmpty();
+				uint32_t emptyAfter = HashControlGroup(&_ctrl[index]).matchEmpty();
+				bool wasNeverFull = emptyBefore != 0 && emptyAfter != 0 &&
+					(Bits::countTrailingZeros(emptyAfter) + (Bits::countLeadingZeros(emptyBefore) - 16)) < HashControlGroup::WIDTH;
+
+				if (wasNeverFull) {
+					setCtrl(index, HashControlGroup::EMPTY);
+					_growthLeft++;
+				}
+				else {
+					setCtrl(index, HashControlGroup::DELETED);
+				}
+
+				return true;
+			}
+
+			/* Returns the first EMPTY or DELETED slot in the probe sequence of the provided hash. */
+			uint32_t findFirstNonFull(const uint64_t hash) const {
+				uint32_t mask = _capacity - 1;
+				uint32_t pos = getH1(hash) & mask;
+				uint32_t step = 0;
+
+				while (true) {
+					uint32_t available = HashControlGroup(&_ctrl[pos]).matchEmptyOrDeleted();
+					if (available != 0)
+						return (pos + Bits::countTrailingZeros(available)) & mask;
+
+					step += HashControlGroup::WIDTH;
+					pos = (pos + step) & mask;
+				}
+			}
+
+			/* Claims a slot for a new entry with the provided hash, rehashing first if needed. The caller must construct the entry. */
+			uint32_t prepareInsert(const uint64_t hash) {
+				uint32_t index = _capacity > 0 ? findFirstNonFull(hash) : NOT_FOUND;
+
+				// Reusing a DELETED slot does not reduce the number of EMPTY slots.
+				if (index == NOT_FOUND || (_growthLeft == 0 && _ctrl[index] != HashControlGroup::DELETED)) {
+					rehashForInsert();
+					index = findFirstNonFull(hash);
+				}
+
+				if (_ctrl[index] == HashControlGroup::EMPTY)
+					_growthLeft--;
+
+				setCtrl(index, getH2(hash));
+				_count++;
+				return index;
+			}
+
+			/*	If at least half of the occupied slots are DELETED, they are purged at the current capacity. Otherwise the table doubles in size,
+				or grows further if a low load factor means doubling would still leave no room for the new entry. */
+			void rehashForInsert() {
+				if (_capacity == 0) {
+					resize(MIN_CAPACITY);
+				}
+				else if (_count * 2 <= getMaxEntries(_capacity)) {
+					resize(_capacity);
+				}
+				else {
+					uint32_t required = getCapacityFor(_count + 1);
+					resize(required > _capacity * 2 ? required : _capacity * 2);
+				}
+			}
+
+			void resize(const uint32_t newCapacity) {
+				assert(Bits::isPowerOfTwo(newCapacity) && newCapacity >= MIN_CAPACITY);
+
+				int8_t* oldCtrl = _ctrl;
+				KeyValuePair<K, V>* oldSlots = _slots;
+				uint32_t oldCapacity = _capacity;
+
+				_capacity = newCapacity;
+				_ctrl = _allocator->allocType<int8_t>(newCapacity + HashControlGroup::WIDTH);
+				_slots = _allocator->allocType<KeyValuePair<K, V>>(newCapacity);
+				_growthLeft = getMaxEntries(newCapacity) - _count;
+				memset(_ctrl, HashControlGroup::EMPTY, newCapacity + HashControlGroup::WIDTH);
+
+				// Move every entry into the new table. Its hash is recalculated, since only 7 bits of it are stored.
+				for (uint32_t i = 0; i < oldCapacity; i++) {
+					if (oldCtrl[i] < 0)
+						continue;
+
+					KeyValuePair<K, V>& entry = oldSlots[i];
+					uint64_t hash = _hashFunc(entry.Key);
+					uint32_t index = findFirstNonFull(hash);
+					setCtrl(index, getH2(hash));
+
+					new (&_slots[index]) KeyValuePair<K, V>{ std::move(entry.Key), std::move(entry.Value) };
+					entry.~KeyValuePair<K, V>();
 				}
 
-				_allocator->dealloc(_table);
+				if (oldCapacity > 0) {
+					_allocator->dealloc(oldCtrl);
+					_allocator->dealloc(oldSlots);
+				}
+			}
+
+			void copyFrom(const Dictionary& other) {
+				if (other._count == 0)
+					return;
+
+				ensureCapacity(other._count);
+				for (uint32_t i = 0; i < other._capacity; i++) {
+					if (other._ctrl[i] >= 0)
+						put(other._slots[i].Key, other._slots[i].Value);
+				}
+			}
+
+			void takeFrom(Dictionary& other) {
+				_ctrl = other._ctrl;
+				_slots = other._slots;
+				_capacity = other._capacity;
+				_count = other._count;
+				_growthLeft = other._growthLeft;
+				_maxLoadFactor = other._maxLoadFactor;
+				_allocator = other._allocator;
+
+				other._ctrl = nullptr;
+				other._slots = nullptr;
+				other._capacity = 0;
+				other._count = 0;
+				other._growthLeft = 0;
+			}
+
+			void destroySlots() {
+				for (uint32_t i = 0; i < _capacity; i++) {
+					if (_ctrl[i] >= 0)
+						_slots[i].~KeyValuePair<K, V>();
+				}
+			}
+
+			void destroyTable() {
+				if (_capacity == 0)
+					return;
+
+				destroySlots();
+				_allocator->dealloc(_ctrl);
+				_allocator->dealloc(_slots);
+				_ctrl = nullptr;
+				_slots = nullptr;
+				_capacity = 0;
+				_count = 0;
+				_growthLeft = 0;
 			}
 		};
 	}
@@ -24,4 +24,16 @@ namespace fe {
 		const uint32_t _maxIndex;
 		const uint32_t _index;
 	};
+
+	struct NumberFormatException : public std::exception {
+		inline NumberFormatException() :
+			_msg("The string was not in a valid number format.") {}
+
+		inline const char* message() const throw() {
+			return _msg;
+		}
+
+	private:
+		const char* _msg;
+	};
 }
\ No newline at end of file
@@ -1,11 +1,12 @@
 #include "ferrous.h"
+#include "coroutine_scheduler.h"
 
 namespace fe {
 	FerrousInstance::FerrousInstance() {
 		_mem = Memory::get(); // TODO this is where we should set the page size.
-		_time = _mem->allocType<GameTime>();
-		_settings = _mem->allocType<Settings>();
-		_log = _mem->allocType<Logger>();
+		_time = new (_mem->allocType<GameTime>()) GameTime();
+		_settings = new (_mem->allocType<Settings>()) Settings();
+		_log = new (_mem->allocType<Logger>()) Logger();
 		_stopping = false;
 	}
 
@@ -16,6 +17,7 @@ namespace fe {
 
 		_time = nullptr;
 		_settings = nullptr;
+		_log = nullptr;
 		_mem = nullptr;
 	}
 
@@ -33,6 +35,7 @@ namespace fe {
 
 	void FerrousInstance::start() {
 		// TODO device and asset initialization goes here
+		JobSystem::start();
 
 		onStart(_time, _settings);
 
@@ -41,11 +44,15 @@ namespace fe {
 
 			for (int i = 0; i < updates_needed; i++) {
 				_log->writeLine(FeString::format("Frame %d -- time: %f ms -- delta: %f"_fe, _time->getFrameId(), _time->getFrameTime(), _time->getDelta()));
+#ifdef FE_COROUTINES
+				CoroutineScheduler::update(_time);
+#endif
 				onUpdate(_time);
 			}
 		}
 
 		onStopping();
+		JobSystem::stop();
 		_log->writeLine("Finished shut down"_fe);
 		_stopping = false;
 	}
@@ -3,6 +3,7 @@
 #include "allocation.h"
 #include "game_time.h"
 #include "logging.h"
+#include "job_system.h"
 
 namespace fe {
 	/* A base class on which to build an application, to interact with Ferrous Engine.*/
@@ -11,7 +12,7 @@ namespace fe {
 		FerrousInstance();
 		~FerrousInstance();
 
-		/* initialize the engine. */
+		/* initialize the engine. Starts the JobSystem, with the calling thread as its main thread, and runs the update loop on it. */
 		void start();
 
 		/* shutdown the engine.*/
@@ -27,7 +28,7 @@ namespace fe {
 		GameTime* getTime();
 
 	protected:
-		/* Invoked when an update is performed.*/
+		/* Invoked when an update is performed. Work can be fanned out across every core with JobSystem or fe::parallel.*/
 		virtual void onUpdate(GameTime* time) = 0;
 
 		/* Invoked right before the update loop is started. This is usually after a call to start(). */
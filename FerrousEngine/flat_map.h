@@ -0,0 +1,264 @@
+#pragma once
+#include "soa_list.h"
+#include "hash.h"
+#include "key_value_pair.h"
+#include "sorted_search.h"
+#include <initializer_list>
+
+namespace fe {
+	namespace collections {
+		/*	A map stored as two sorted, contiguous columns (keys, then values) in a single allocation. Lookups are a branchless binary search
+			over densely packed keys, which never touches a value until the key is found, and entries can be queried by key range.
+			Adding or removing an entry moves every entry after it, so the map suits tables which are built once (ideally in bulk, with the
+			entry-array constructor) and then mostly read. For tables which change often, use Dictionary.
+			L orders the keys. If it defines is_transparent, the map can be queried with any type L accepts. See: DefaultKeyLess. */
+		template <typename K, typename V, typename L = DefaultKeyLess<K>>
+		class FlatMap {
+			template <typename C, typename = void>
+			struct IsTransparent : std::false_type {};
+
+			template <typename C>
+			struct IsTransparent<C, std::void_t<typename C::is_transparent>> : std::true_type {};
+
+			template <typename Q>
+			using EnableLookup = std::enable_if_t<IsTransparent<L>::value, Q>;
+
+		public:
+			/* Creates a new map. Memory is not allocated until the first entry is added, unless an initial capacity is provided. */
+			FlatMap(uint32_t initialCapacity = 0, FerrousAllocator* allocator = Memory::get()) : _entries(initialCapacity, allocator) { }
+
+			/*	Builds a map from count entries with a single sort, and stores it in one allocation of exactly the right size.
+				If a key appears more than once, the last entry with that key wins, as if each entry had been put() in order. */
+			FlatMap(const KeyValuePair<K, V>* entries, uint32_t count, FerrousAllocator* allocator = Memory::get()) : _entries(0, allocator) {
+				build(entries, count, allocator);
+			}
+
+			FlatMap(std::initializer_list<KeyValuePair<K, V>> entries, FerrousAllocator* allocator = Memory::get()) : _entries(0, allocator) {
+				build(entries.begin(), (uint32_t)entries.size(), allocator);
+			}
+
+			bool containsKey(const K& key) const {
+				return find(key) != NOT_FOUND;
+			}
+
+			/*	Transparent lookup. Accepts any type accepted by L, if L defines is_transparent.
+				e.g. A FlatMap<FeString, V> can be queried with a FeStringView or a U"literal", without constructing a FeString. */
+			template <typename Q, typename = EnableLookup<Q>>
+			bool containsKey(const Q& key) const {
+				return find(key) != NOT_FOUND;
+			}
+
+			V get(const K& key) const {
+				return getValue(key);
+			}
+
+			template <typename Q, typename = EnableLookup<Q>>
+			V get(const Q& key) const {
+				return getValue(key);
+			}
+
+			bool tryGet(const K& key, V& value) const {
+				return tryGetValue(key, value);
+			}
+
+			template <typename Q, typename = EnableLookup<Q>>
+			bool tryGet(const Q& key, V& value) const {
+				return tryGetValue(key, value);
+			}
+
+			/* Adds an entry, keeping the keys sorted, or updates the value of an existing entry with the same key. */
+			void put(const K& key, const V& value) {
+				uint32_t index = lowerBound(key);
+
+				if (index < count() && !_less(key, keyData()[index]))
+					valueData()[index] = value;
+				else
+					_entries.insert(index, key, value);
+			}
+
+			bool remove(const K& key) {
+				return removeKey(key);
+			}
+
+			template <typename Q, typename = EnableLookup<Q>>
+			bool remove(const Q& key) {
+				return removeKey(key);
+			}
+
+			/* Returns the index of the first key which is not less than key, or count() if there is none. */
+			inline uint32_t lowerBound(const K& key) const {
+				return SortedSearch::lowerBound(keyData(), count(), key, _less);
+			}
+
+			template <typename Q, typename = EnableLookup<Q>>
+			inline uint32_t lowerBound(const Q& key) const {
+				return SortedSearch::lowerBound(keyData(), count(), key, _less);
+			}
+
+			/* Returns the index of the first key which is greater than key, or count() if there is none. */
+			inline uint32_t upperBound(const K& key) const {
+				return SortedSearch::upperBound(keyData(), count(), key, _less);
+			}
+
+			template <typename Q, typename = EnableLookup<Q>>
+			inline uint32_t upperBound(const Q& key) const {
+				return SortedSearch::upperBound(keyData(), count(), key, _less);
+			}
+
+			/*	Returns every key, in order. The value of keys()[i] is values()[i], so a range of entries can be visited with e.g.
+				for (uint32_t i = map.lowerBound(min), end = map.upperBound(max); i < end; i++) use(map.keys()[i], map.values()[i]); */
+			inline Span<const K> keys() const {
+				return _entries.template field<0>();
+			}
+
+			/* Returns every value, in the order of their keys. */
+			inline Span<V> values() {
+				return _entries.template field<1>();
+			}
+
+			inline Span<const V> values() const {
+				return _entries.template field<1>();
+			}
+
+			/* Returns the values whose keys are not less than min and not greater than max, in order. */
+			inline Span<V> valuesInRange(const K& min, const K& max) {
+				return getRange(values(), min, max);
+			}
+
+			template <typename Q, typename = EnableLookup<Q>>
+			inline Span<V> valuesInRange(const Q& min, const Q& max) {
+				return getRange(values(), min, max);
+			}
+
+			/* Returns the keys which are not less than min and not greater than max, in order. */
+			inline Span<const K> keysInRange(const K& min, const K& max) const {
+				return getRange(keys(), min, max);
+			}
+
+			template <typename Q, typename = EnableLookup<Q>>
+			inline Span<const K> keysInRange(const Q& min, const Q& max) const {
+				return getRange(keys(), min, max);
+			}
+
+			inline void clear() {
+				_entries.clear();
+			}
+
+			/* Ensures the map can hold at least the specified number of entries without reallocating. */
+			inline void reserve(uint32_t capacity) {
+				_entries.reserve(capacity);
+			}
+
+			/* Gets the number of entries in the map. */
+			inline uint32_t count() const {
+				return _entries.count();
+			}
+
+			inline bool isEmpty() const {
+				return _entries.isEmpty();
+			}
+
+			inline V& operator[] (const K& key) {
+				return getValueRef(key);
+			}
+
+			template <typename Q, typename = EnableLookup<Q>>
+			inline V& operator[] (const Q& key) {
+				return getValueRef(key);
+			}
+
+		private:
+			static constexpr uint32_t NOT_FOUND = UINT32_MAX;
+
+			SoAList<K, V> _entries;
+			L _less;
+
+			inline const K* keyData() const {
+				return _entries.template field<0>().data();
+			}
+
+			inline V* valueData() {
+				return _entries.template field<1>().data();
+			}
+
+			inline const V* valueData() const {
+				return _entries.template field<1>().data();
+			}
+
+			template <typename Q>
+			inline uint32_t find(const Q& key) const {
+				uint32_t index = SortedSearch::lowerBound(keyData(), count(), key, _less);
+				return (index < count() && !_less(key, keyData()[index])) ? index : NOT_FOUND;
+			}
+
+			template <typename Q>
+			V getValue(const Q& key) const {
+				uint32_t index = find(key);
+				if (index == NOT_FOUND)
+					throw "Key not found.";
+
+				return valueData()[index];
+			}
+
+			template <typename Q>
+			V& getValueRef(const Q& key) {
+				uint32_t index = find(key);
+				if (index == NOT_FOUND)
+					throw "Key not found.";
+
+				return valueData()[index];
+			}
+
+			template <typename Q>
+			bool tryGetValue(const Q& key, V& value) const {
+				uint32_t index = find(key);
+				if (index == NOT_FOUND)
+					return false;
+
+				value = valueData()[index];
+				return true;
+			}
+
+			template <typename Q>
+			bool removeKey(const Q& key) {
+				uint32_t index = find(key);
+				if (index == NOT_FOUND)
+					return false;
+
+				_entries.removeAt(index);
+				return true;
+			}
+
+			template <typename T, typename Q>
+			inline Span<T> getRange(Span<T> column, const Q& min, const Q& max) const {
+				uint32_t start = SortedSearch::lowerBound(keyData(), count(), min, _less);
+				uint32_t end = SortedSearch::upperBound(keyData(), count(), max, _less);
+				return end > start ? column.slice(start, end - start) : Span<T>();
+			}
+
+			void build(const KeyValuePair<K, V>* entries, uint32_t count, FerrousAllocator* allocator) {
+				if (count == 0)
+					return;
+
+				// Sort indices rather than entries, so each entry is only copied once, straight into its final place.
+				uint32_t* order = allocator->allocType<uint32_t>(count);
+				SortedSearch::sortIndices(order, count, [entries](uint32_t i) -> const K& { return entries[i].Key; }, _less);
+
+				// Equal keys keep their original order, so the last of each run is the entry to keep.
+				uint32_t unique = 1;
+				for (uint32_t i = 1; i < count; i++) {
+					if (_less(entries[order[i - 1]].Key, entries[order[i]].Key))
+						unique++;
+				}
+
+				_entries.reserve(unique);
+				for (uint32_t i = 0; i < count; i++) {
+					if (i + 1 == count || _less(entries[order[i]].Key, entries[order[i + 1]].Key))
+						_entries.add(entries[order[i]].Key, entries[order[i]].Value);
+				}
+
+				allocator->dealloc(order);
+			}
+		};
+	}
+}
\ No newline at end of file
@@ -0,0 +1,183 @@
+#pragma once
+#include "list.h"
+#include "span.h"
+#include "hash.h"
+#include "sorted_search.h"
+#include <initializer_list>
+
+namespace fe {
+	namespace collections {
+		/*	A set of unique keys, stored sorted in one contiguous array. Lookups are a branchless binary search over densely packed keys,
+			and keys can be queried by range. Adding or removing a key moves every key after it, so the set suits tables which are built once
+			(ideally in bulk, with the key-array constructor) and then mostly read.
+			L orders the keys. If it defines is_transparent, the set can be queried with any type L accepts. See: DefaultKeyLess. */
+		template <typename K, typename L = DefaultKeyLess<K>>
+		class FlatSet {
+			template <typename C, typename = void>
+			struct IsTransparent : std::false_type {};
+
+			template <typename C>
+			struct IsTransparent<C, std::void_t<typename C::is_transparent>> : std::true_type {};
+
+			template <typename Q>
+			using EnableLookup = std::enable_if_t<IsTransparent<L>::value, Q>;
+
+		public:
+			using const_iterator = typename List<K>::const_iterator;
+
+			/* Creates a new set. Memory is not allocated until the first key is added, unless an initial capacity is provided. */
+			FlatSet(uint32_t initialCapacity = 0, FerrousAllocator* allocator = Memory::get()) : _keys(initialCapacity, allocator) { }
+
+			/* Builds a set from count keys with a single sort, and stores it in one allocation of exactly the right size. Duplicates are dropped. */
+			FlatSet(const K* keys, uint32_t count, FerrousAllocator* allocator = Memory::get()) : _keys(0, allocator) {
+				build(keys, count, allocator);
+			}
+
+			FlatSet(std::initializer_list<K> keys, FerrousAllocator* allocator = Memory::get()) : _keys(0, allocator) {
+				build(keys.begin(), (uint32_t)keys.size(), allocator);
+			}
+
+			inline const_iterator begin() const { return _keys.begin(); }
+			inline const_iterator end() const { return _keys.end(); }
+
+			/* Adds a key, keeping the keys sorted. Returns false if the set already contains the key. */
+			bool add(const K& key) {
+				uint32_t index = lowerBound(key);
+				if (index < _keys.count() && !_less(key, _keys[index]))
+					return false;
+
+				_keys.insert(key, index);
+				return true;
+			}
+
+			bool contains(const K& key) const {
+				return find(key) != NOT_FOUND;
+			}
+
+			/* Transparent lookup. Accepts any type accepted by L, if L defines is_transparent. */
+			template <typename Q, typename = EnableLookup<Q>>
+			bool contains(const Q& key) const {
+				return find(key) != NOT_FOUND;
+			}
+
+			bool remove(const K& key) {
+				return removeKey(key);
+			}
+
+			template <typename Q, typename = EnableLookup<Q>>
+			bool remove(const Q& key) {
+				return removeKey(key);
+			}
+
+			/* Returns the index of the first key which is not less than key, or count() if there is none. */
+			inline uint32_t lowerBound(const K& key) const {
+				return SortedSearch::lowerBound(_keys.data(), _keys.count(), key, _less);
+			}
+
+			template <typename Q, typename = EnableLookup<Q>>
+			inline uint32_t lowerBound(const Q& key) const {
+				return SortedSearch::lowerBound(_keys.data(), _keys.count(), key, _less);
+			}
+
+			/* Returns the index of the first key which is greater than key, or count() if there is none. */
+			inline uint32_t upperBound(const K& key) const {
+				return SortedSearch::upperBound(_keys.data(), _keys.count(), key, _less);
+			}
+
+			template <typename Q, typename = EnableLookup<Q>>
+			inline uint32_t upperBound(const Q& key) const {
+				return SortedSearch::upperBound(_keys.data(), _keys.count(), key, _less);
+			}
+
+			/* Returns the keys which are not less than min and not greater than max, in order. */
+			inline Span<const K> range(const K& min, const K& max) const {
+				return getRange(min, max);
+			}
+
+			template <typename Q, typename = EnableLookup<Q>>
+			inline Span<const K> range(const Q& min, const Q& max) const {
+				return getRange(min, max);
+			}
+
+			/* Returns every key, in order. */
+			inline Span<const K> keys() const {
+				return Span<const K>(_keys.data(), _keys.count());
+			}
+
+			inline void clear() {
+				_keys.clear();
+			}
+
+			/* Ensures the set can hold at least the specified number of keys without reallocating. */
+			inline void reserve(uint32_t capacity) {
+				_keys.reserve(capacity);
+			}
+
+			/* Frees unused capacity. Call once a set has finished loading. */
+			inline void trim() {
+				_keys.trim();
+			}
+
+			inline uint32_t count() const { return _keys.count(); }
+			inline bool isEmpty() const { return _keys.count() == 0; }
+
+			/* Gets the key at the specified position in the sorted order. */
+			inline const K& operator[] (uint32_t index) const {
+				return _keys[index];
+			}
+
+		private:
+			static constexpr uint32_t NOT_FOUND = UINT32_MAX;
+
+			List<K> _keys;
+			L _less;
+
+			template <typename Q>
+			inline uint32_t find(const Q& key) const {
+				uint32_t index = SortedSearch::lowerBound(_keys.data(), _keys.count(), key, _less);
+				return (index < _keys.count() && !_less(key, _keys[index])) ? index : NOT_FOUND;
+			}
+
+			template <typename Q>
+			bool removeKey(const Q& key) {
+				uint32_t index = find(key);
+				if (index == NOT_FOUND)
+					return false;
+
+				_keys.removeAt(index);
+				return true;
+			}
+
+			template <typename Q>
+			inline Span<const K> getRange(const Q& min, const Q& max) const {
+				uint32_t start = SortedSearch::lowerBound(_keys.data(), _keys.count(), min, _less);
+				uint32_t end = SortedSearch::upperBound(_keys.data(), _keys.count(), max, _less);
+				return Span<const K>(_keys.data() + start, end > start ? end - start : 0);
+			}
+
+			void build(const K* keys, uint32_t count, FerrousAllocator* allocator) {
+				if (count == 0)
+					return;
+
+				// Sort indices rather than keys, so each key is only copied once, straight into its final place.
+				uint32_t* order = allocator->allocType<uint32_t>(count);
+				SortedSearch::sortIndices(order, count, [keys](uint32_t i) -> const K& { return keys[i]; }, _less);
+
+				uint32_t unique = 1;
+				for (uint32_t i = 1; i < count; i++) {
+					if (_less(keys[order[i - 1]], keys[order[i]]))
+						unique++;
+				}
+
+				_keys.reserve(unique);
+				_keys.add(keys[order[0]]);
+				for (uint32_t i = 1; i < count; i++) {
+					if (_less(keys[order[i - 1]], keys[order[i]]))
+						_keys.add(keys[order[i]]);
+				}
+
+				allocator->dealloc(order);
+			}
+		};
+	}
+}
\ No newline at end of file
@@ -1,8 +1,19 @@
 #include "game_time.h"
 #include <thread>
+#include <math.h>
+
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
 
 namespace fe {
-	GameTime::GameTime(bool fixedTimestep, uint32_t targetFps) {
+	/* Overshoot statistics are a running mean over this many recent sleeps, so the spin margin follows changes in system load. */
+	static const uint32_t OVERSHOOT_WINDOW = 100;
+
+	/* The spin margin before enough sleeps have been measured to estimate it. */
+	static const double DEFAULT_SPIN_MARGIN = 2.0;
+
+	GameTime::GameTime(bool fixedTimestep, uint32_t targetFps, FramePacing pacing) {
 		_is_fixed = fixedTimestep;
 		setTargetFps(targetFps);
 		_fps = 0;
@@ -12,10 +23,25 @@ namespace fe {
 		_delta = 0;
 		_accumulated = 0;
 		_prev_time = std::chrono::high_resolution_clock::now();
+
+		_pacing = pacing;
+		_overshoot_samples = 0;
+		_overshoot_mean = 0;
+		_overshoot_m2 = 0;
+
+#ifdef _WIN32
+		// High-resolution timers need Windows 10 1803 or later. Without one, sleep() falls back to the (coarser) scheduler tick.
+		_sleep_timer = CreateWaitableTimerExW(NULL, NULL, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+#else
+		_sleep_timer = nullptr;
+#endif
 	}
 
 	GameTime::~GameTime() {
-
+#ifdef _WIN32
+		if (_sleep_timer != nullptr)
+			CloseHandle(_sleep_timer);
+#endif
 	}
 
 	bool GameTime::getPaused() {
@@ -43,6 +69,22 @@ namespace fe {
 		_is_fixed = fixed;
 	}
 
+	FramePacing GameTime::getPacing() {
+		return _pacing;
+	}
+
+	void GameTime::setPacing(FramePacing pacing) {
+		_pacing = pacing;
+	}
+
+	double GameTime::getSpinMargin() {
+		if (_overshoot_samples < 2)
+			return DEFAULT_SPIN_MARGIN;
+
+		// One standard deviation above the mean overshoot.
+		return _overshoot_mean + sqrt(_overshoot_m2 / (_overshoot_samples - 1));
+	}
+
 	uint32_t GameTime::getFps() {
 		return _fps;
 	}
@@ -67,10 +109,58 @@ namespace fe {
 		return _delta;
 	}
 
+	void GameTime::sleep(double ms) {
+#ifdef _WIN32
+		if (_sleep_timer != nullptr) {
+			LARGE_INTEGER due;
+			due.QuadPart = -(LONGLONG)(ms * 10000.0); // Negative for a relative time, in 100-nanosecond intervals.
+			if (SetWaitableTimer(_sleep_timer, &due, 0, NULL, NULL, FALSE)) {
+				WaitForSingleObject(_sleep_timer, INFINITE);
+				return;
+			}
+		}
+#endif
+		std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(ms));
+	}
+
+	void GameTime::waitForFrame() {
+		auto now = std::chrono::high_resolution_clock::now();
+		double elapsed = std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(now - _prev_time).count();
+		double remaining = _target_time - (_accumulated + elapsed);
+		if (remaining <= 0)
+			return;
+
+		auto due = now + std::chrono::duration_cast<std::chrono::high_resolution_clock::duration>(std::chrono::duration<double, std::milli>(remaining));
+
+		// Sleep until the spin margin before the frame is due, then record how late the sleep woke up.
+		double sleep_time = remaining - getSpinMargin();
+		if (sleep_time > 0) {
+			sleep(sleep_time);
+			double slept = std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(std::chrono::high_resolution_clock::now() - now).count();
+			double overshoot = slept - sleep_time;
+
+			if (_overshoot_samples < OVERSHOOT_WINDOW)
+				_overshoot_samples++;
+
+			// Welford's running mean and variance, with the sample count capped so old sleeps are gradually forgotten.
+			double delta = overshoot - _overshoot_mean;
+			_overshoot_mean += delta / _overshoot_samples;
+			_overshoot_m2 += delta * (overshoot - _overshoot_mean);
+			if (_overshoot_samples == OVERSHOOT_WINDOW)
+				_overshoot_m2 *= (double)(OVERSHOOT_WINDOW - 1) / OVERSHOOT_WINDOW;
+		}
+
+		while (std::chrono::high_resolution_clock::now() < due) {
+#ifdef FE_SSE2
+			_mm_pause();
+#endif
+		}
+	}
+
 	uint32_t GameTime::tick() {
-		// TODO: Implement custom sleep() func to pad times and "sleep" most of it away then spinway for the padded amount.
-		//		 This is to help reduce CPU usage from ticking endlessly during fixed-timestep.
-		// http://www.cplusplus.com/forum/windows/33865/
+		if (_is_fixed && _pacing == FramePacing::SleepThenSpin)
+			waitForFrame();
+
 		auto time = std::chrono::high_resolution_clock::now();
 		auto time_elapsed = std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(time - _prev_time);
 		double elapsed = time_elapsed.count();
@@ -4,9 +4,19 @@
 #include <chrono>
 
 namespace fe {
+	/* How tick() waits for the next fixed-timestep frame. */
+	enum class FramePacing : uint8_t {
+		/* tick() returns immediately, with 0 updates if none are due. The caller's loop spins at 100% CPU between frames. */
+		Spin = 0,
+
+		/*	tick() sleeps through most of the time until the next frame with a high-resolution timer, then spins for a final margin.
+			The margin adapts to how far past its requested wake-up time each sleep overshoots. */
+		SleepThenSpin = 1,
+	};
+
 	class GameTime {
 	public:
-		GameTime(bool fixedTimestep = true, uint32_t targetFps = 60);
+		GameTime(bool fixedTimestep = true, uint32_t targetFps = 60, FramePacing pacing = FramePacing::SleepThenSpin);
 		~GameTime();
 
 		bool getPaused();
@@ -18,6 +28,13 @@ namespace fe {
 		bool getFixedTimestep();
 		void setFixedTimestep(bool fixed);
 
+		/* Pacing only applies to a fixed timestep. A variable timestep runs an update on every tick(). */
+		FramePacing getPacing();
+		void setPacing(FramePacing pacing);
+
+		/* The time, in milliseconds, which SleepThenSpin pacing spins for instead of sleeping. */
+		double getSpinMargin();
+
 		uint32_t getFps();
 		double getFrameTime();
 		double getTargetFrameTime();
@@ -29,7 +46,8 @@ namespace fe {
 
 		double getDelta();
 
-		/* Updates the current game time and returns the number of updates required to advance. */
+		/*	Updates the current game time and returns the number of updates required to advance.
+			With SleepThenSpin pacing and a fixed timestep, waits until at least one update is due first. */
 		uint32_t tick();
 	private:
 		bool _is_fixed;
@@ -45,5 +63,16 @@ namespace fe {
 
 		std::chrono::high_resolution_clock::time_point _prev_time;
 		std::chrono::high_resolution_clock::time_point _prev_tick_time;
+
+		FramePacing _pacing;
+		void* _sleep_timer; /* A high-resolution waitable timer, or nullptr where unavailable. */
+		uint32_t _overshoot_samples;
+		double _overshoot_mean;
+		double _overshoot_m2; /* Sum of squared differences from the mean, for the variance of the overshoot. */
+
+		/* Sleeps, then spins, until the next fixed-timestep frame is due. */
+		void waitForFrame();
+
+		void sleep(double ms);
 	};
 }
\ No newline at end of file
@@ -0,0 +1,80 @@
+#include "hash.h"
+
+namespace fe {
+	namespace collections {
+		static inline uint64_t read64(const uint8_t* p) {
+			uint64_t v;
+			memcpy(&v, p, sizeof(v));
+			return v;
+		}
+
+		static inline uint64_t read32(const uint8_t* p) {
+			uint32_t v;
+			memcpy(&v, p, sizeof(v));
+			return v;
+		}
+
+		/* Reads 1 to 3 bytes. */
+		static inline uint64_t read3(const uint8_t* p, const size_t k) {
+			return (((uint64_t)p[0]) << 16) | (((uint64_t)p[k >> 1]) << 8) | p[k - 1];
+		}
+
+		uint64_t Hash::bytes(const void* data, const size_t numBytes, uint64_t seed) {
+			const uint8_t* p = static_cast<const uint8_t*>(data);
+			uint64_t a;
+			uint64_t b;
+			seed ^= mum(seed ^ SECRET[0], SECRET[1]);
+
+			if (numBytes <= 16) {
+				if (numBytes >= 4) {
+					// Two overlapping reads from each end cover every byte, without branching on the exact length.
+					size_t offset = (numBytes >> 3) << 2;
+					a = (read32(p) << 32) | read32(p + offset);
+					b = (read32(p + numBytes - 4) << 32) | read32(p + numBytes - 4 - offset);
+				}
+				else if (numBytes > 0) {
+					a = read3(p, numBytes);
+					b = 0;
+				}
+				else {
+					a = 0;
+					b = 0;
+				}
+			}
+			else {
+				size_t remaining = numBytes;
+
+				// Three independent lanes, so the multiplies can overlap.
+				if (remaining > 48) {
+					uint64_t see1 = seed;
+					uint64_t see2 = seed;
+
+					do {
+						seed = mum(read64(p) ^ SECRET[1], read64(p + 8) ^ seed);
+						see1 = mum(read64(p + 16) ^ SECRET[2], read64(p + 24) ^ see1);
+						see2 = mum(read64(p + 32) ^ SECRET[3], read64(p + 40) ^ see2);
+						p += 48;
+						remaining -= 48;
+					} while (remaining > 48);
+
+					seed ^= see1 ^ see2;
+				}
+
+				while (remaining > 16) {
+					seed = mum(read64(p) ^ SECRET[1], read64(p + 8) ^ seed);
+					p += 16;
+					remaining -= 16;
+				}
+
+				// The last 16 bytes, which may overlap bytes that were already hashed.
+				a = read64(p + remaining - 16);
+				b = read64(p + remaining - 8);
+			}
+
+			a ^= SECRET[1];
+			b ^= seed;
+			multiply(a, b);
+			return mum(a ^ SECRET[0] ^ numBytes, b ^ SECRET[1]);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,122 @@
+#pragma once
+#include "stdafx.h"
+#include <type_traits>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace fe {
+	namespace collections {
+		/*	Hash function class. Returns a well-distributed 64-bit hash of a key, since hash tables reduce it by masking off the low bits.
+			Specialized for integers, enums, pointers, floating-point numbers and FeString. See also: shapes_hash.h.
+			Other types are hashed by their bytes, if they contain no padding. Anything else requires a specialization. */
+		template <typename K>
+		struct DefaultKeyHash;
+
+		/*	Default key comparer class. Specializations (and custom comparers) which define is_transparent, along with their hash function,
+			allow hash tables to be queried with any type they accept, without constructing a key. */
+		template <typename K>
+		struct DefaultKeyEquals {
+			bool operator()(const K& a, const K& b) const
+			{
+				return a == b;
+			}
+		};
+
+		/*	Default key ordering class, used by sorted containers such as FlatMap. Like DefaultKeyEquals, specializations which define
+			is_transparent allow those containers to be queried with any type they accept. */
+		template <typename K>
+		struct DefaultKeyLess {
+			bool operator()(const K& a, const K& b) const
+			{
+				return a < b;
+			}
+		};
+
+		/*	A lookup key paired with a precomputed hash, so a hash table does not need to hash it again.
+			The hash must have been produced by the table's hash function. e.g. PrehashedKey<FeStringView>{ name, nameHash } */
+		template <typename Q>
+		struct PrehashedKey {
+			Q key;
+			uint64_t hash;
+		};
+
+		/* Hashing primitives. Byte hashing is based on wyhash (public domain): https://github.com/wangyi-fudan/wyhash */
+		class Hash {
+		public:
+			/* Hashes a block of memory. Different seeds produce independent hashes of the same data. */
+			static uint64_t bytes(const void* data, const size_t numBytes, const uint64_t seed = 0);
+
+			/* Scrambles a 64-bit value, so that every bit of the result depends on every bit of the input. */
+			static inline uint64_t mix(const uint64_t value) {
+				return mum(value ^ SECRET[0], SECRET[1]);
+			}
+
+			/* Combines two hashes into one. The order matters: combine(a, b) differs from combine(b, a). */
+			static inline uint64_t combine(const uint64_t seed, const uint64_t hash) {
+				return mum(seed ^ SECRET[2], hash ^ SECRET[3]);
+			}
+
+			/* Hashes a composite key from its members. e.g. Hash::of(key.id, key.name) */
+			template <typename T, typename... Rest>
+			static inline uint64_t of(const T& first, const Rest&... rest) {
+				uint64_t result = DefaultKeyHash<T>()(first);
+				((result = combine(result, DefaultKeyHash<Rest>()(rest))), ...);
+				return result;
+			}
+
+		private:
+			static constexpr uint64_t SECRET[4] = { 0x2d358dccaa6c78a5ULL, 0x8bb84b93962eacc9ULL, 0x4b33a62ed433d4a3ULL, 0x4d5a2da51de1aa47ULL };
+
+			/* Multiplies a and b into a 128-bit product. The lower half is stored in a and the upper half in b. */
+			static inline void multiply(uint64_t& a, uint64_t& b) {
+#if defined(__SIZEOF_INT128__)
+				__uint128_t r = (__uint128_t)a * b;
+				a = (uint64_t)r;
+				b = (uint64_t)(r >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+				a = _umul128(a, b, &b);
+#else
+				uint64_t ha = a >> 32, la = (uint32_t)a, hb = b >> 32, lb = (uint32_t)b;
+				uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+				uint64_t t = rl + (rm0 << 32);
+				uint64_t c = t < rl;
+				uint64_t lo = t + (rm1 << 32);
+				c += lo < t;
+				a = lo;
+				b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+			}
+
+			/* Multiplies a and b into a 128-bit product, then folds the upper half into the lower half. */
+			static inline uint64_t mum(uint64_t a, uint64_t b) {
+				multiply(a, b);
+				return a ^ b;
+			}
+		};
+
+		template <typename K>
+		struct DefaultKeyHash {
+			uint64_t operator()(const K& key) const {
+				if constexpr (std::is_integral<K>::value || std::is_enum<K>::value) {
+					return Hash::mix((uint64_t)key);
+				}
+				else if constexpr (std::is_pointer<K>::value) {
+					return Hash::mix((uint64_t)reinterpret_cast<uintptr_t>(key));
+				}
+				else if constexpr (std::is_floating_point<K>::value) {
+					// 0.0 and -0.0 are equal, but have different bits.
+					K value = key == (K)0 ? (K)0 : key;
+					return Hash::bytes(&value, sizeof(K));
+				}
+				else {
+					static_assert(std::has_unique_object_representations<K>::value,
+						"DefaultKeyHash cannot hash the bytes of a type which contains padding. Specialize DefaultKeyHash for it instead.");
+
+					return Hash::bytes(&key, sizeof(K));
+				}
+			}
+		};
+	}
+}
\ No newline at end of file
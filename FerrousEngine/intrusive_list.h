@@ -0,0 +1,182 @@
+#pragma once
+#include "stdafx.h"
+#include <iterator>
+
+namespace fe {
+	namespace collections {
+		/* Links an object into an IntrusiveList. Embed one per list the object can be in. An object must be removed before it is destroyed. */
+		struct IntrusiveListNode {
+			IntrusiveListNode* prev = nullptr;
+			IntrusiveListNode* next = nullptr;
+
+			/* Returns true if the node is currently in a list. */
+			inline bool isLinked() const { return next != nullptr; }
+		};
+
+		/*	A doubly linked list of objects which contain their own links, so adding and removing never allocates, and an object can remove
+			itself in O(1) without searching. The list does not own its objects. Member is the object's IntrusiveListNode member.
+			e.g. struct Texture { IntrusiveListNode lruNode; }; IntrusiveList<Texture, &Texture::lruNode> lru; lru.moveToFront(texture); */
+		template<typename T, IntrusiveListNode T::* Member>
+		class IntrusiveList {
+		public:
+			template<bool IsConst>
+			class Iterator {
+				using Node = std::conditional_t<IsConst, const IntrusiveListNode, IntrusiveListNode>;
+
+			public:
+				using value_type = T;
+				using reference = std::conditional_t<IsConst, const T&, T&>;
+				using pointer = std::conditional_t<IsConst, const T*, T*>;
+				using difference_type = std::ptrdiff_t;
+				using iterator_category = std::bidirectional_iterator_tag;
+
+				Iterator(Node* node) : _node(node) { }
+
+				inline reference operator*() const { return *getItem(const_cast<IntrusiveListNode*>(_node)); }
+				inline pointer operator->() const { return getItem(const_cast<IntrusiveListNode*>(_node)); }
+
+				inline Iterator& operator++() {
+					_node = _node->next;
+					return *this;
+				}
+
+				inline Iterator& operator--() {
+					_node = _node->prev;
+					return *this;
+				}
+
+				inline bool operator ==(const Iterator& other) const { return _node == other._node; }
+				inline bool operator !=(const Iterator& other) const { return _node != other._node; }
+
+			private:
+				Node* _node;
+			};
+
+			using iterator = Iterator<false>;
+			using const_iterator = Iterator<true>;
+
+			IntrusiveList() {
+				_head.prev = &_head;
+				_head.next = &_head;
+				_count = 0;
+			}
+
+			// The objects point back at the list's head node, so the list cannot be copied or moved.
+			IntrusiveList(const IntrusiveList& other) = delete;
+			IntrusiveList& operator=(const IntrusiveList& other) = delete;
+
+			~IntrusiveList() {
+				clear();
+			}
+
+			inline iterator begin() { return iterator(_head.next); }
+			inline iterator end() { return iterator(&_head); }
+			inline const_iterator begin() const { return const_iterator(_head.next); }
+			inline const_iterator end() const { return const_iterator(&_head); }
+
+			inline void pushFront(T& item) { linkAfter(&_head, getNode(item)); }
+			inline void pushBack(T& item) { linkAfter(_head.prev, getNode(item)); }
+
+			/* Inserts item directly before position, which must be in this list. */
+			inline void insertBefore(T& position, T& item) { linkAfter(getNode(position)->prev, getNode(item)); }
+
+			/* Inserts item directly after position, which must be in this list. */
+			inline void insertAfter(T& position, T& item) { linkAfter(getNode(position), getNode(item)); }
+
+			/* Removes item, which must be in this list. */
+			inline void remove(T& item) {
+				unlink(getNode(item));
+			}
+
+			/* Removes and returns the first item, or returns nullptr if the list is empty. */
+			inline T* popFront() {
+				if (_count == 0)
+					return nullptr;
+
+				IntrusiveListNode* node = _head.next;
+				unlink(node);
+				return getItem(node);
+			}
+
+			/* Removes and returns the last item, or returns nullptr if the list is empty. */
+			inline T* popBack() {
+				if (_count == 0)
+					return nullptr;
+
+				IntrusiveListNode* node = _head.prev;
+				unlink(node);
+				return getItem(node);
+			}
+
+			/* Moves an item in this list to the front. e.g. marking an entry as most recently used. */
+			inline void moveToFront(T& item) {
+				IntrusiveListNode* node = getNode(item);
+				unlink(node);
+				linkAfter(&_head, node);
+			}
+
+			/* Moves an item in this list to the back. */
+			inline void moveToBack(T& item) {
+				IntrusiveListNode* node = getNode(item);
+				unlink(node);
+				linkAfter(_head.prev, node);
+			}
+
+			/* Returns the first item, or nullptr if the list is empty. */
+			inline T* front() { return _count > 0 ? getItem(_head.next) : nullptr; }
+
+			/* Returns the last item, or nullptr if the list is empty. */
+			inline T* back() { return _count > 0 ? getItem(_head.prev) : nullptr; }
+
+			/* Unlinks every item. The items themselves are not destroyed. */
+			void clear() {
+				IntrusiveListNode* node = _head.next;
+				while (node != &_head) {
+					IntrusiveListNode* next = node->next;
+					node->prev = nullptr;
+					node->next = nullptr;
+					node = next;
+				}
+
+				_head.prev = &_head;
+				_head.next = &_head;
+				_count = 0;
+			}
+
+			inline uint32_t count() const { return _count; }
+			inline bool isEmpty() const { return _count == 0; }
+
+		private:
+			IntrusiveListNode _head;	/* Sentinel. The list is circular through it, so linking never needs a null check. */
+			uint32_t _count;
+
+			static inline IntrusiveListNode* getNode(T& item) {
+				return &(item.*Member);
+			}
+
+			/* Finds the object which contains the node, from the member's offset within T. */
+			static inline T* getItem(IntrusiveListNode* node) {
+				const size_t offset = reinterpret_cast<size_t>(&(reinterpret_cast<T*>(0)->*Member));
+				return reinterpret_cast<T*>(reinterpret_cast<char*>(node) - offset);
+			}
+
+			inline void linkAfter(IntrusiveListNode* position, IntrusiveListNode* node) {
+				assert(!node->isLinked());
+				node->prev = position;
+				node->next = position->next;
+				position->next->prev = node;
+				position->next = node;
+				_count++;
+			}
+
+			inline void unlink(IntrusiveListNode* node) {
+				assert(node->isLinked());
+				node->prev->next = node->next;
+				node->next->prev = node->prev;
+				node->prev = nullptr;
+				node->next = nullptr;
+				_count--;
+			}
+		};
+	}
+}
\ No newline at end of file
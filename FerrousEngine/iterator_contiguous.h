@@ -0,0 +1,111 @@
+#pragma once
+#include "stdafx.h"
+#include <iterator>
+#include <type_traits>
+
+namespace fe {
+	namespace collections {
+		/*	Iterates over elements stored next to each other in memory, such as the items of a List.
+			Satisfies the random-access iterator requirements (and contiguous_iterator in C++20), so it works with std::sort,
+			std::lower_bound and the parallel standard algorithms. Use ContiguousIterator<const T> for read-only iteration. */
+		template<typename T>
+		class ContiguousIterator {
+		public:
+			using value_type = std::remove_cv_t<T>;
+			using reference = T&;
+			using pointer = T*;
+			using difference_type = std::ptrdiff_t;
+			using iterator_category = std::random_access_iterator_tag; // See: https://en.cppreference.com/w/cpp/iterator/iterator_tags
+#if __cplusplus >= 202002L || (defined(_MSVC_LANG) && _MSVC_LANG >= 202002L)
+			using iterator_concept = std::contiguous_iterator_tag;
+#endif
+
+			ContiguousIterator() : _data(nullptr) { }
+
+			explicit ContiguousIterator(T* data, uint32_t index) {
+				_data = data + index;
+			}
+
+			/* Allows an iterator to be converted to its read-only equivalent. */
+			template<typename U, typename = std::enable_if_t<std::is_same<const U, T>::value>>
+			ContiguousIterator(const ContiguousIterator<U>& other) : _data(other.operator->()) { }
+
+			inline T& operator*() const { return *_data; }
+			inline T* operator->() const { return _data; }
+			inline T& operator[](difference_type offset) const { return _data[offset]; }
+
+			inline ContiguousIterator& operator++() {
+				_data++;
+				return *this;
+			}
+
+			inline ContiguousIterator operator++(int) {
+				ContiguousIterator result = *this;
+				_data++;
+				return result;
+			}
+
+			inline ContiguousIterator& operator--() {
+				_data--;
+				return *this;
+			}
+
+			inline ContiguousIterator operator--(int) {
+				ContiguousIterator result = *this;
+				_data--;
+				return result;
+			}
+
+			inline ContiguousIterator& operator+=(difference_type offset) {
+				_data += offset;
+				return *this;
+			}
+
+			inline ContiguousIterator& operator-=(difference_type offset) {
+				_data -= offset;
+				return *this;
+			}
+
+			inline ContiguousIterator operator+(difference_type offset) const {
+				return ContiguousIterator(_data + offset, 0);
+			}
+
+			inline friend ContiguousIterator operator+(difference_type offset, const ContiguousIterator& it) {
+				return it + offset;
+			}
+
+			inline ContiguousIterator operator-(difference_type offset) const {
+				return ContiguousIterator(_data - offset, 0);
+			}
+
+		private:
+			T* _data;
+		};
+
+		/*	Iterators are compared, and subtracted, as non-members, so that a mutable and a read-only iterator over the same type work in
+			either order. e.g. it == list.cend() and list.cend() == it. */
+		template<typename A, typename B>
+		using EnableIteratorPair = std::enable_if_t<std::is_same<std::remove_cv_t<A>, std::remove_cv_t<B>>::value>;
+
+		template<typename A, typename B, typename = EnableIteratorPair<A, B>>
+		inline std::ptrdiff_t operator -(const ContiguousIterator<A>& a, const ContiguousIterator<B>& b) { return a.operator->() - b.operator->(); }
+
+		template<typename A, typename B, typename = EnableIteratorPair<A, B>>
+		inline bool operator ==(const ContiguousIterator<A>& a, const ContiguousIterator<B>& b) { return a.operator->() == b.operator->(); }
+
+		template<typename A, typename B, typename = EnableIteratorPair<A, B>>
+		inline bool operator !=(const ContiguousIterator<A>& a, const ContiguousIterator<B>& b) { return a.operator->() != b.operator->(); }
+
+		template<typename A, typename B, typename = EnableIteratorPair<A, B>>
+		inline bool operator <(const ContiguousIterator<A>& a, const ContiguousIterator<B>& b) { return a.operator->() < b.operator->(); }
+
+		template<typename A, typename B, typename = EnableIteratorPair<A, B>>
+		inline bool operator >(const ContiguousIterator<A>& a, const ContiguousIterator<B>& b) { return a.operator->() > b.operator->(); }
+
+		template<typename A, typename B, typename = EnableIteratorPair<A, B>>
+		inline bool operator <=(const ContiguousIterator<A>& a, const ContiguousIterator<B>& b) { return a.operator->() <= b.operator->(); }
+
+		template<typename A, typename B, typename = EnableIteratorPair<A, B>>
+		inline bool operator >=(const ContiguousIterator<A>& a, const ContiguousIterator<B>& b) { return a.operator->() >= b.operator->(); }
+	}
+}
\ No newline at end of file
@@ -0,0 +1,356 @@
+#include "job_system.h"
+#include "allocation.h"
+#include "concurrent_work_stealing_deque.h"
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+
+namespace fe {
+	/* The most pages of jobs each thread may allocate. */
+	static constexpr uint32_t MAX_JOB_PAGES = 64;
+	static constexpr uint32_t JOBS_PER_PAGE = (Memory::PAGE_FREE_SIZE - FE_CACHE_LINE_SIZE - 1) / sizeof(Job);
+
+	/*	The state of one thread in the job system. Jobs are bump-allocated from a list of pages, which rewinds to the start once every job
+		the thread allocated has finished, like a frame allocator. The list grows one page at a time, up to MAX_JOB_PAGES; a thread which
+		runs out of jobs runs new work immediately instead. */
+	struct JobThread {
+		collections::WorkStealingDeque<Job> queue;
+		uint32_t index;
+		uint32_t pageCount;
+		uint32_t page;
+		uint32_t slot;
+		Job* pages[MAX_JOB_PAGES];
+		alignas(FE_CACHE_LINE_SIZE) std::atomic<uint32_t> liveJobs;	/* Jobs allocated by this thread which have not finished. */
+
+		JobThread(uint32_t threadIndex) : queue(JobSystem::QUEUE_CAPACITY) {
+			index = threadIndex;
+			pageCount = 0;
+			page = 0;
+			slot = 0;
+			liveJobs.store(0, std::memory_order_relaxed);
+		}
+
+		~JobThread() {
+			for (uint32_t i = 0; i < pageCount; i++)
+				Memory::get()->dealloc(pages[i]);
+		}
+
+		void addPage() {
+			pages[pageCount++] = static_cast<Job*>(Memory::get()->alloc(sizeof(Job) * JOBS_PER_PAGE, FE_CACHE_LINE_SIZE));
+		}
+	};
+
+	/* Holds the progress of one parallelFor() range, on the stack of the thread which called it. */
+	struct ParallelForBatch {
+		JobSystem::RangeFunc func;
+		void* context;
+		uint32_t count;
+		uint32_t grain;
+		alignas(FE_CACHE_LINE_SIZE) std::atomic<uint64_t> next;	/* The start of the next unclaimed chunk. 64-bit, so claims past the end cannot wrap. */
+		std::atomic<bool> failed;
+		std::mutex exceptionMutex;
+		std::exception_ptr exception;
+
+		void process() {
+			while (!failed.load(std::memory_order_relaxed)) {
+				uint64_t start = next.fetch_add(grain, std::memory_order_relaxed);
+				if (start >= count)
+					break;
+
+				uint64_t end = start + grain;
+				if (end > count)
+					end = count;
+
+				try {
+					func(context, (uint32_t)start, (uint32_t)end);
+				}
+				catch (...) {
+					std::lock_guard<std::mutex> lock(exceptionMutex);
+					if (!exception)
+						exception = std::current_exception();
+
+					failed.store(true, std::memory_order_relaxed);
+				}
+			}
+		}
+	};
+
+	static JobThread** _threads = nullptr;
+	static std::thread* _workers = nullptr;
+	static uint32_t _threadCount = 0;
+	static std::atomic<bool> _running(false);
+	static std::atomic<bool> _stopping(false);
+
+	static std::mutex _sleepMutex;
+	static std::condition_variable _wake;	/* Signalled when a job is queued while a worker sleeps, or the system is stopping. */
+	static std::atomic<int64_t> _queued(0);	/* Jobs sitting in a queue. Workers only sleep while this is zero. */
+	static std::atomic<uint32_t> _sleepers(0);
+
+	static thread_local JobThread* _current = nullptr;
+
+	/* Pops a job from the thread's own queue, or steals one from another thread, starting with the next thread along. */
+	static Job* findJob(JobThread* self) {
+		Job* job = self->queue.tryPop();
+		for (uint32_t i = 1; job == nullptr && i < _threadCount; i++)
+			job = _threads[(self->index + i) % _threadCount]->queue.trySteal();
+
+		if (job != nullptr)
+			_queued.fetch_sub(1, std::memory_order_seq_cst);
+
+		return job;
+	}
+
+	void JobSystem::push(Job* job) {
+		_queued.fetch_add(1, std::memory_order_seq_cst);
+		if (!_current->queue.tryPush(job)) {
+			_queued.fetch_sub(1, std::memory_order_seq_cst);
+			execute(job);
+			return;
+		}
+
+		// Paired with the sleeper count increment in workerMain(). Either the pusher sees the sleeper, or the sleeper sees the job.
+		if (_sleepers.load(std::memory_order_seq_cst) > 0) {
+			std::lock_guard<std::mutex> lock(_sleepMutex);
+			_wake.notify_one();
+		}
+	}
+
+	void JobSystem::workerMain(JobThread* self) {
+		_current = self;
+		uint32_t idleSpins = 0;
+
+		while (!_stopping.load(std::memory_order_acquire)) {
+			Job* job = findJob(self);
+			if (job != nullptr) {
+				execute(job);
+				idleSpins = 0;
+				continue;
+			}
+
+			// Spin briefly before sleeping, since another job often arrives within the same frame.
+			if (++idleSpins < 64) {
+				std::this_thread::yield();
+				continue;
+			}
+
+			std::unique_lock<std::mutex> lock(_sleepMutex);
+			_sleepers.fetch_add(1, std::memory_order_seq_cst);
+			_wake.wait(lock, [] { return _stopping.load(std::memory_order_acquire) || _queued.load(std::memory_order_seq_cst) > 0; });
+			_sleepers.fetch_sub(1, std::memory_order_relaxed);
+			idleSpins = 0;
+		}
+
+		_current = nullptr;
+	}
+
+	void JobSystem::start(uint32_t workerCount) {
+		if (_running.load(std::memory_order_acquire))
+			return;
+
+		if (workerCount == 0) {
+			uint32_t hardwareThreads = std::thread::hardware_concurrency();
+			workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+		}
+
+		if (workerCount > MAX_WORKERS)
+			workerCount = MAX_WORKERS;
+
+		Memory* mem = Memory::get();
+		_threadCount = workerCount + 1;
+		_threads = mem->allocType<JobThread*>(_threadCount);
+		for (uint32_t i = 0; i < _threadCount; i++) {
+			_threads[i] = new (mem->allocType<JobThread>()) JobThread(i);
+			_threads[i]->addPage();
+		}
+
+		_stopping.store(false, std::memory_order_relaxed);
+		_current = _threads[0];
+		_running.store(true, std::memory_order_release);
+
+		if (workerCount > 0) {
+			_workers = mem->allocType<std::thread>(workerCount);
+			for (uint32_t i = 0; i < workerCount; i++)
+				new (&_workers[i]) std::thread(workerMain, _threads[i + 1]);
+		}
+	}
+
+	void JobSystem::stop() {
+		if (!_running.load(std::memory_order_acquire))
+			return;
+
+		assert(_current == _threads[0]); // Stop must be called from the thread which started the job system.
+
+		// Help finish every outstanding job, including those which workers have queued, before the workers exit.
+		for (uint32_t i = 0; i < _threadCount; i++) {
+			while (_threads[i]->liveJobs.load(std::memory_order_acquire) > 0) {
+				Job* job = findJob(_current);
+				if (job != nullptr)
+					execute(job);
+				else
+					std::this_thread::yield();
+			}
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(_sleepMutex);
+			_stopping.store(true, std::memory_order_release);
+		}
+
+		_wake.notify_all();
+
+		Memory* mem = Memory::get();
+		for (uint32_t i = 0; i + 1 < _threadCount; i++) {
+			_workers[i].join();
+			_workers[i].~thread();
+		}
+
+		if (_workers != nullptr)
+			mem->dealloc(_workers);
+
+		for (uint32_t i = 0; i < _threadCount; i++)
+			mem->deallocType(_threads[i]);
+
+		mem->dealloc(_threads);
+		_workers = nullptr;
+		_threads = nullptr;
+		_threadCount = 0;
+		_current = nullptr;
+		_running.store(false, std::memory_order_release);
+	}
+
+	bool JobSystem::isRunning() {
+		return _running.load(std::memory_order_acquire);
+	}
+
+	uint32_t JobSystem::getThreadCount() {
+		return _running.load(std::memory_order_acquire) ? _threadCount : 1;
+	}
+
+	bool JobSystem::isJobThread() {
+		return _current != nullptr;
+	}
+
+	Job* JobSystem::allocateJob() {
+		JobThread* self = _current;
+		if (self == nullptr)
+			return nullptr;
+
+		// Every job this thread allocated has finished, so all of its pages can be reused.
+		if (self->liveJobs.load(std::memory_order_acquire) == 0) {
+			self->page = 0;
+			self->slot = 0;
+		}
+
+		if (self->slot == JOBS_PER_PAGE) {
+			self->page++;
+			self->slot = 0;
+		}
+
+		if (self->page == self->pageCount) {
+			if (self->pageCount == MAX_JOB_PAGES)
+				return nullptr;
+
+			self->addPage();
+		}
+
+		self->liveJobs.fetch_add(1, std::memory_order_relaxed);
+		Job* job = &self->pages[self->page][self->slot++];
+		job->owner = self;
+		job->nextWaiting = nullptr;
+		return job;
+	}
+
+	void JobSystem::submit(Job* job, JobCounter* dependency) {
+		if (dependency != nullptr) {
+			dependency->lock();
+			if (dependency->_count.load(std::memory_order_relaxed) > 0) {
+				job->nextWaiting = dependency->_waiting;
+				dependency->_waiting = job;
+				dependency->unlock();
+				return;
+			}
+
+			dependency->unlock();
+		}
+
+		push(job);
+	}
+
+	void JobSystem::execute(Job* job) {
+		job->execute(job);
+
+		JobCounter* counter = job->counter;
+		JobThread* owner = job->owner;
+
+		if (counter != nullptr) {
+			// Decrement under the lock, so a thread returning from wait() cannot destroy the counter while it is still in use here.
+			Job* waiting = nullptr;
+			counter->lock();
+			if (counter->_count.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+				waiting = counter->_waiting;
+				counter->_waiting = nullptr;
+			}
+
+			counter->unlock();
+
+			while (waiting != nullptr) {
+				Job* next = waiting->nextWaiting;
+				push(waiting);
+				waiting = next;
+			}
+		}
+
+		owner->liveJobs.fetch_sub(1, std::memory_order_release);
+	}
+
+	void JobSystem::wait(JobCounter& counter) {
+		JobThread* self = _current;
+		while (!counter.isComplete()) {
+			Job* job = self != nullptr ? findJob(self) : nullptr;
+			if (job != nullptr)
+				execute(job);
+			else
+				std::this_thread::yield();
+		}
+
+		// Wait for the thread which completed the counter to release it.
+		counter.lock();
+		counter.unlock();
+	}
+
+	void JobSystem::parallelFor(uint32_t count, uint32_t grain, RangeFunc func, void* context) {
+		if (grain == 0)
+			grain = 1;
+
+		// Runs serially, but still in chunks of grain indices, since callers such as parallel::reduce() keep a result per chunk.
+		if (count <= grain || _current == nullptr || _threadCount < 2) {
+			for (uint64_t start = 0; start < count; start += grain)
+				func(context, (uint32_t)start, count - start > grain ? (uint32_t)(start + grain) : count);
+
+			return;
+		}
+
+		ParallelForBatch batch;
+		batch.func = func;
+		batch.context = context;
+		batch.count = count;
+		batch.grain = grain;
+		batch.next.store(0, std::memory_order_relaxed);
+		batch.failed.store(false, std::memory_order_relaxed);
+
+		// One helper per other thread, at most one per chunk beyond the caller's first. Helpers which start late find nothing left and return.
+		uint32_t chunkCount = (uint32_t)(((uint64_t)count + grain - 1) / grain);
+		uint32_t helperCount = _threadCount - 1 < chunkCount - 1 ? _threadCount - 1 : chunkCount - 1;
+
+		JobCounter counter;
+		ParallelForBatch* batchPtr = &batch;
+		for (uint32_t i = 0; i < helperCount; i++)
+			run([batchPtr] { batchPtr->process(); }, &counter);
+
+		batch.process();
+		wait(counter);
+
+		if (batch.exception)
+			std::rethrow_exception(batch.exception);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,164 @@
+#pragma once
+#include "stdafx.h"
+#include <atomic>
+#include <utility>
+#include <new>
+#include <type_traits>
+#include <thread>
+
+namespace fe {
+	struct JobThread;
+	class JobCounter;
+
+	/*	A unit of work, allocated from the frame allocator of the thread which created it. Callers never see a Job; they pass a function
+		object to JobSystem::run(), which is stored in data, so it must fit in DATA_SIZE bytes (e.g. a lambda capturing up to four pointers). */
+	struct alignas(FE_CACHE_LINE_SIZE) Job {
+		static constexpr size_t DATA_SIZE = 32;
+
+		void (*execute)(Job* job);	/* Calls, then destroys, the function object stored in data. */
+		JobCounter* counter;
+		JobThread* owner;
+		Job* nextWaiting;			/* The next job waiting on the same dependency. */
+		alignas(8) unsigned char data[DATA_SIZE];
+	};
+
+	/*	Counts unfinished jobs. Each job run with a counter increments it, and decrements it once complete, so one counter can track a
+		whole batch of jobs. Jobs can also wait on a counter as a dependency, with JobSystem::runAfter(), and are queued once it reaches zero.
+		A counter must outlive its jobs: only destroy it once JobSystem::wait() has returned for it. */
+	class JobCounter {
+	public:
+		JobCounter() : _count(0), _waiting(nullptr) { }
+
+		JobCounter(const JobCounter& other) = delete;
+		JobCounter& operator=(const JobCounter& other) = delete;
+
+		inline bool isComplete() const { return _count.load(std::memory_order_acquire) == 0; }
+
+		inline uint32_t getCount() const { return _count.load(std::memory_order_acquire); }
+
+	private:
+		friend class JobSystem;
+
+		std::atomic<uint32_t> _count;
+		std::atomic_flag _lock = ATOMIC_FLAG_INIT;	/* Guards _waiting, and each decrement of _count. */
+		Job* _waiting;
+
+		inline void lock() {
+			while (_lock.test_and_set(std::memory_order_acquire))
+				std::this_thread::yield();
+		}
+
+		inline void unlock() {
+			_lock.clear(std::memory_order_release);
+		}
+	};
+
+	/*	A work-stealing job system, with one worker thread per core. Each thread, including the one which called start(), pushes new jobs
+		onto its own Chase-Lev deque and pops the newest first. A thread which runs out of jobs steals the oldest job of another thread.
+		Waiting on a counter runs other jobs until it completes, rather than blocking, so jobs may freely create and wait on other jobs.
+		Jobs are bump-allocated per thread and reused once every job a thread created has finished; typically once per frame.
+		A job run from a thread which is not part of the system, or before start(), runs on the calling thread instead, once its dependency completes.
+		Jobs must not throw, except inside parallelFor(). */
+	class JobSystem {
+	public:
+		/* Called with a [start, end) range of indices to process. */
+		using RangeFunc = void(*)(void* context, uint32_t start, uint32_t end);
+
+		static constexpr uint32_t MAX_WORKERS = 63;
+
+		/* The number of jobs each thread can have queued. A job created while its thread's queue is full runs immediately instead. */
+		static constexpr uint32_t QUEUE_CAPACITY = 512;
+
+		/*	Starts the workers, and makes the calling thread part of the system. A workerCount of 0 starts one worker per hardware thread,
+			minus one for the calling thread. Does nothing if the system is already running. */
+		static void start(uint32_t workerCount = 0);
+
+		/* Finishes every queued job, then stops and joins the workers. Must be called from the thread which called start(). */
+		static void stop();
+
+		static bool isRunning();
+
+		/* The number of threads which run jobs, including the thread which called start(). 1 if the system is not running. */
+		static uint32_t getThreadCount();
+
+		/* Returns true if the calling thread can queue and wait on jobs. */
+		static bool isJobThread();
+
+		/* Queues func() to run on any thread. If a counter is provided, it is incremented now, and decremented once func() returns. */
+		template<typename Func>
+		static void run(Func&& func, JobCounter* counter = nullptr) {
+			Job* job = createJob(std::forward<Func>(func), nullptr, counter);
+			if (job != nullptr)
+				submit(job, nullptr);
+		}
+
+		/*	Queues func() to run once dependency reaches zero. e.g. JobSystem::runAfter(physicsDone, [world] { world->syncTransforms(); }, &frameDone);
+			If no job can be allocated, waits for dependency on the calling thread, then calls func() before returning. */
+		template<typename Func>
+		static void runAfter(JobCounter& dependency, Func&& func, JobCounter* counter = nullptr) {
+			Job* job = createJob(std::forward<Func>(func), &dependency, counter);
+			if (job != nullptr)
+				submit(job, &dependency);
+		}
+
+		/* Runs other jobs until counter reaches zero. */
+		static void wait(JobCounter& counter);
+
+		/*	Calls func(start, end) over [0, count) in chunks of grain indices, and returns once every chunk is complete. Chunks are claimed
+			from a shared counter by one helper job per thread, and by the calling thread, so faster threads take more chunks. If func throws,
+			the first exception is rethrown once the range completes; chunks which were not yet claimed are skipped. */
+		template<typename Func>
+		static inline void parallelFor(uint32_t count, uint32_t grain, Func&& func) {
+			using F = std::remove_reference_t<Func>;
+			parallelFor(count, grain, [](void* context, uint32_t start, uint32_t end) {
+				(*static_cast<F*>(context))(start, end);
+			}, const_cast<void*>(static_cast<const void*>(&func)));
+		}
+
+		static void parallelFor(uint32_t count, uint32_t grain, RangeFunc func, void* context);
+
+	private:
+		/* Allocates a job from the calling thread's frame allocator. Returns nullptr if the calling thread cannot run jobs, or is out of jobs. */
+		static Job* allocateJob();
+
+		/* Queues the job, or adds it to the dependency's waiting list if the dependency is not complete. */
+		static void submit(Job* job, JobCounter* dependency);
+
+		/* Pushes the job onto the calling thread's queue, waking a sleeping worker if there is one. */
+		static void push(Job* job);
+
+		static void execute(Job* job);
+
+		static void workerMain(JobThread* self);
+
+		/* Stores func in a new job. If no job can be allocated, waits for the dependency if there is one, calls func, and returns nullptr. */
+		template<typename Func>
+		static Job* createJob(Func&& func, JobCounter* dependency, JobCounter* counter) {
+			using F = std::decay_t<Func>;
+			static_assert(sizeof(F) <= Job::DATA_SIZE, "The job function must fit in Job::DATA_SIZE bytes. Capture less, or capture a pointer to the state.");
+			static_assert(alignof(F) <= 8, "The job function must not require more than 8-byte alignment.");
+
+			Job* job = allocateJob();
+			if (job == nullptr) {
+				if (dependency != nullptr)
+					wait(*dependency);
+
+				func();
+				return nullptr;
+			}
+
+			new (job->data) F(std::forward<Func>(func));
+			job->execute = [](Job* j) {
+				F* f = reinterpret_cast<F*>(j->data);
+				(*f)();
+				f->~F();
+			};
+
+			job->counter = counter;
+			if (counter != nullptr)
+				counter->_count.fetch_add(1, std::memory_order_relaxed);
+
+			return job;
+		}
+	};
+}
\ No newline at end of file
@@ -2,137 +2,214 @@
 #include "collection.h"
 #include "allocation.h"
 #include "exceptions.h"
+#include "relocation.h"
+#include "iterator_contiguous.h"
 
 namespace fe {
 	namespace collections {
+		/* Uninitialized storage for the items a List holds inside itself. Empty when InlineCapacity is 0. */
+		template<typename T, uint32_t InlineCapacity>
+		class ListInlineStorage {
+		protected:
+			inline T* inlineItems() { return reinterpret_cast<T*>(_inline); }
+			inline const T* inlineItems() const { return reinterpret_cast<const T*>(_inline); }
+
+		private:
+			alignas(T) unsigned char _inline[sizeof(T) * InlineCapacity];
+		};
+
 		template<typename T>
-		class List : public Collection<T> {
+		class ListInlineStorage<T, 0> {
+		protected:
+			inline T* inlineItems() { return nullptr; }
+			inline const T* inlineItems() const { return nullptr; }
+		};
+
+		/*	A dynamic array. Elements are moved with memcpy when IsTriviallyRelocatable<T>, or with their move constructor otherwise,
+			so the list can safely hold types which own resources (e.g. FeString). Removed elements are destroyed.
+			Up to InlineCapacity items are stored inside the list itself, and the allocator is only used beyond that (see SmallList).
+			An empty list does not allocate. */
+		template<typename T, uint32_t InlineCapacity = 0>
+		class FE_EMPTY_BASES List : private ListInlineStorage<T, InlineCapacity>, public Collection<T, List<T, InlineCapacity>> {
 			// Pull super-class protected member in.
-			using Collection<T>::_count;
+			using Collection<T, List<T, InlineCapacity>>::_count;
+			using ListInlineStorage<T, InlineCapacity>::inlineItems;
 
 		public:
-			inline List(uint32_t initialCapacity = 1, FerrousAllocator* allocator = Memory::get()) : Collection<T>() {
-				assert(initialCapacity > 0);
-
+			inline List(uint32_t initialCapacity = 0, FerrousAllocator* allocator = Memory::get()) : Collection<T, List<T, InlineCapacity>>() {
 				_allocator = allocator;
-				_capacity = initialCapacity;
-				_first = _allocator->allocType<T>(_capacity);
+				_first = inlineItems();
+				_capacity = InlineCapacity;
+
+				if (initialCapacity > InlineCapacity)
+					reallocate(initialCapacity);
 			}
 
-			ForwardRangeIterator<T> begin() {
-				return ForwardRangeIterator<T>(_first, 0);
+			List(const List& other) : List(other._count, other._allocator) {
+				Relocation::copy(_first, other._first, other._count);
+				_count = other._count;
 			}
 
-			ForwardRangeIterator<T> end() {
-				return ForwardRangeIterator<T>(_first, _count);
+			List(List&& other) noexcept : Collection<T, List<T, InlineCapacity>>() {
+				takeFrom(other);
 			}
 
-			inline bool insert(T item, uint32_t index) {
-				if(index < 0 || index > _count)
-					throw IndexOutOfRangeExeption(index, _count);
+			~List() {
+				release();
+			}
 
-				// Ensure capacity.
-				// We're inserting between existing items.
-				if (index < _count) {
-					T* dest = _first;
+			List& operator=(const List& other) {
+				if (this != &other) {
+					clear();
+					ensureCapacity(other._count);
+					Relocation::copy(_first, other._first, other._count);
+					_count = other._count;
+				}
 
-					if (_count == _capacity) {
-						_capacity *= 2;
-						dest = _allocator->allocType<T>(_capacity);
-					}
+				return *this;
+			}
 
-					if (index == 0) {
-						Memory::copyType(&dest[1], _first, _count);
-					}
-					else {
-						// Split elements into two parts, leaving a 1-element gap, for the new item to be inserted.
-						Memory::copyType(dest, _first, index);
-						Memory::copyType(&dest[index + 1], &_first[index], _count - index);
-					}
+			List& operator=(List&& other) noexcept {
+				if (this != &other) {
+					release();
+					takeFrom(other);
+				}
 
-					// Deallocate old memory, if new was allocated.
-					if (_first != dest) {
-						_allocator->dealloc(_first);
-						_first = dest;
-					}
+				return *this;
+			}
 
-					_first[index] = item;
-					return true;
+			using iterator = ContiguousIterator<T>;
+			using const_iterator = ContiguousIterator<const T>;
+			using reverse_iterator = std::reverse_iterator<iterator>;
+			using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+			inline iterator begin() { return iterator(_first, 0); }
+			inline iterator end() { return iterator(_first, _count); }
+			inline const_iterator begin() const { return const_iterator(_first, 0); }
+			inline const_iterator end() const { return const_iterator(_first, _count); }
+			inline const_iterator cbegin() const { return const_iterator(_first, 0); }
+			inline const_iterator cend() const { return const_iterator(_first, _count); }
+
+			inline reverse_iterator rbegin() { return reverse_iterator(end()); }
+			inline reverse_iterator rend() { return reverse_iterator(begin()); }
+			inline const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+			inline const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+			/* Returns a pointer to the first item. Items are stored contiguously, so [data(), data() + count()) is a valid range. */
+			inline T* data() { return _first; }
+			inline const T* data() const { return _first; }
+
+			inline bool insert(const T& item, uint32_t index) {
+				emplaceAt(index, item);
+				return true;
+			}
+
+			inline bool insert(T&& item, uint32_t index) {
+				emplaceAt(index, std::move(item));
+				return true;
+			}
+
+			/* Constructs a new item at the specified index, from the provided constructor arguments. Returns the new item. */
+			template<typename... Args>
+			T& emplaceAt(uint32_t index, Args&&... args) {
+				if (index > _count)
+					throw IndexOutOfRangeExeption(index, _count);
+
+				if (index == _count)
+					return emplace(std::forward<Args>(args)...);
+
+				if (_count == _capacity) {
+					// Relocate straight into the new memory, leaving a gap for the new item, so no element is moved twice.
+					// The new item is constructed first, in case the arguments refer to an existing element.
+					uint32_t newCapacity = getGrowthCapacity(_count + 1);
+					T* newMem = _allocator->allocType<T>(newCapacity);
+					new (&newMem[index]) T(std::forward<Args>(args)...);
+
+					Relocation::relocate(newMem, _first, index);
+					Relocation::relocate(&newMem[index + 1], &_first[index], _count - index);
+					replaceMemory(newMem, newCapacity);
 				}
-				else { // We're appending to the end (i.e. equal to _count).
-					return add(item);
+				else {
+					T item(std::forward<Args>(args)...);
+					Relocation::relocateOverlapping(&_first[index + 1], &_first[index], _count - index);
+					new (&_first[index]) T(std::move(item));
 				}
+
+				_count++;
+				return _first[index];
 			}
 
-			inline bool insertCollection(Collection<T>& items, uint32_t insertIndex, uint32_t startIndex, uint32_t count) {
+			template<typename Derived>
+			inline bool insertCollection(const Collection<T, Derived>& items, uint32_t insertIndex, uint32_t startIndex, uint32_t count) {
 				if (startIndex + count > items.count())
 					throw IndexOutOfRangeExeption(startIndex + count, items.count());
 
-				if (insertIndex < 0 || insertIndex > _count)
+				if (insertIndex > _count)
 					throw IndexOutOfRangeExeption(insertIndex, _count);
 
-				if (insertIndex < _count) {
-					uint32_t required = _count + count;
+				if (count == 0)
+					return true;
 
-					// Do we need to expand capacity?
-					if (required > _capacity) {
-						_capacity *= 2;
+				items.copyTo(openGap(insertIndex, count), startIndex, count);
+				_count += count;
+				return true;
+			}
 
-						// Add whatever we're short by, to the new capacity.
-						if (_capacity < required)
-							_capacity += required - _capacity;
-					}
-					else {
-						uint32_t endCount = _count - insertIndex;
-						Memory::copyType<T>(&_first[insertIndex + 1], &_first[insertIndex], insertIndex);
-						items.copyTo(&_first[insertIndex], startIndex, count);
-					}
+			/*	Inserts count items at the specified index. Existing items after the index are moved only once, regardless of count.
+				items must not point into this list. */
+			inline void insertRange(uint32_t index, const T* items, uint32_t count) {
+				if (index > _count)
+					throw IndexOutOfRangeExeption(index, _count);
 
-					_count += count;
-				}
-				else {
-					addCollection(items, startIndex, count);
-				}
-			}
+				assert(items + count <= _first || items >= _first + _capacity);
 
-			inline bool add(T item) override {
-				if (_count == _capacity) {
-					_capacity *= 2;
+				if (count == 0)
+					return;
 
-					// Copy existing elements to new location.
-					T* newMem = _allocator->allocType<T>(_capacity);
-					Memory::copyType<T>(newMem, _first, _count);
-					_allocator->dealloc(_first);
-					_first = newMem;
-				}
+				Relocation::copy(openGap(index, count), items, count);
+				_count += count;
+			}
 
-				_first[_count++] = item;
+			inline bool add(const T& item) {
+				emplace(item);
 				return true;
 			}
 
-			inline void addCollection(Collection<T>& collection, uint32_t startIndex, uint32_t count) {
-				int required = _count + count;
-
-				if (required > _capacity) {
-					_capacity *= 2;
+			inline bool add(T&& item) {
+				emplace(std::move(item));
+				return true;
+			}
 
-					// Add whatever we're short by, to the new capacity.
-					if (_capacity < required)
-						_capacity += required - _capacity;
+			/* Constructs a new item at the end of the list, from the provided constructor arguments. Returns the new item. */
+			template<typename... Args>
+			T& emplace(Args&&... args) {
+				if (_count == _capacity) {
+					// Construct the new item before relocating, in case the arguments refer to an existing element.
+					uint32_t newCapacity = getGrowthCapacity(_count + 1);
+					T* newMem = _allocator->allocType<T>(newCapacity);
+					new (&newMem[_count]) T(std::forward<Args>(args)...);
 
-					T* newMem = _allocator->allocType<T>(_capacity);
-					Memory::copyType<T>(newMem, _first, _count);
-					_allocator->dealloc(_first);
-					_first = newMem;
+					Relocation::relocate(newMem, _first, _count);
+					replaceMemory(newMem, newCapacity);
+				}
+				else {
+					new (&_first[_count]) T(std::forward<Args>(args)...);
 				}
 
+				return _first[_count++];
+			}
+
+			template<typename Derived>
+			inline void addCollection(const Collection<T, Derived>& collection, uint32_t startIndex, uint32_t count) {
+				ensureCapacity(_count + count);
+
 				// Copy items from collection to the end of the current list.
 				collection.copyTo(&_first[_count], startIndex, count);
 				_count += count;
 			}
 
-			inline bool remove(T item) override {
-				for (int i = 0; i < _count; i++) {
+			inline bool remove(const T& item) {
+				for (uint32_t i = 0; i < _count; i++) {
 					if (_first[i] == item) {
 						removeAt(i);
 						return true;
@@ -142,28 +219,77 @@ namespace fe {
 				return false;
 			}
 
-			inline void removeAt(uint32_t index) {
-				if (index >= _count || index < 0)
+			/*	Removes every item for which predicate(item) returns true, in a single pass which calls predicate once per item.
+				The order of the remaining items is preserved. Returns the number of items removed. */
+			template<typename Predicate>
+			uint32_t removeIf(Predicate predicate) {
+				uint32_t write = 0;
+				uint32_t runStart = 0; // The first item of the run of kept items which has not been moved back yet.
+
+				for (uint32_t i = 0; i < _count; i++) {
+					if (!predicate(_first[i]))
+						continue;
+
+					// Move the run of kept items before this one back in one go, then destroy this one.
+					if (write != runStart)
+						Relocation::relocateOverlapping(&_first[write], &_first[runStart], i - runStart);
+
+					write += i - runStart;
+					runStart = i + 1;
+					_first[i].~T();
+				}
+
+				if (write != runStart)
+					Relocation::relocateOverlapping(&_first[write], &_first[runStart], _count - runStart);
+
+				write += _count - runStart;
+				uint32_t removed = _count - write;
+				_count = write;
+				return removed;
+			}
+
+			/* Removes every instance of item, in a single pass. Returns the number of items removed. */
+			inline uint32_t removeAll(const T& item) {
+				const T value(item); // item may refer to an element which is about to be destroyed.
+				return removeIf([&value](const T& other) { return other == value; });
+			}
+
+			/* Removes the item at the specified index by moving the last item into its place. Does not preserve order, but never shifts the tail. */
+			inline void swapRemove(uint32_t index) {
+				if (index >= _count)
 					throw IndexOutOfRangeExeption(index, _count);
 
-				// If not last element, move all elements ahead of the index, back by one element.
-				if (index < (_count - 1))
-					Memory::copyType<T>(&_first[index], &_first[index + 1], (_count - (index + 1)));
+				_first[index].~T();
+				_count--;
 
+				if (index != _count)
+					Relocation::relocate(&_first[index], &_first[_count], 1);
+			}
+
+			inline void removeAt(uint32_t index) {
+				if (index >= _count)
+					throw IndexOutOfRangeExeption(index, _count);
+
+				// Destroy the item, then move all elements ahead of it back by one element.
+				_first[index].~T();
+				Relocation::relocateOverlapping(&_first[index], &_first[index + 1], _count - (index + 1));
 				_count--;
 			}
 
-			inline void copyTo(T* dest, uint32_t startIndex, uint32_t copyCount) override {
-				if (startIndex >= _count || startIndex < 0)
+			inline void copyTo(T* dest, uint32_t startIndex, uint32_t copyCount) const {
+				if (copyCount == 0)
+					return;
+
+				if (startIndex >= _count)
 					throw IndexOutOfRangeExeption(startIndex, _count);
 
 				if (startIndex + copyCount > _count)
 					throw IndexOutOfRangeExeption(startIndex + copyCount, _count);
 
-				Memory::copyType<T>(dest, &_first[startIndex], copyCount);
+				Relocation::copy(dest, &_first[startIndex], copyCount);
 			}
 
-			inline bool contains(T item) override {
+			inline bool contains(const T& item) const {
 				for (uint32_t i = 0; i < _count; i++) {
 					if (item == _first[i])
 						return true;
@@ -172,37 +298,164 @@ namespace fe {
 				return false;
 			}
 
-			// Removes all empty capacity from the end of the list, if any.
+			// Removes all empty capacity from the end of the list, if any. Moves the items back inside the list if they fit.
 			inline void trim() {
-				if (_capacity == _count)
-					return 0;
+				if (_capacity == _count || isInline())
+					return;
+
+				if (_count <= InlineCapacity) {
+					Relocation::relocate(inlineItems(), _first, _count);
+					replaceMemory(inlineItems(), InlineCapacity);
+					return;
+				}
 
-				T * trimmedMem = _allocator->allocType<T>(_count);
-				Memory::copyType(trimmedMem, _first, _count);
-				_allocator->dealloc(_first);
-				_first = trimmedMem;
-				_capacity = _count;
+				T* trimmedMem = _allocator->allocType<T>(_count);
+				Relocation::relocate(trimmedMem, _first, _count);
+				replaceMemory(trimmedMem, _count);
 			}
 
-			inline void clear() override {
+			/* Ensures the list can hold at least the specified number of items without reallocating. */
+			inline void reserve(uint32_t capacity) {
+				if (capacity > _capacity)
+					reallocate(capacity);
+			}
+
+			/* Changes the number of items. New items are value-initialized and items beyond the new count are destroyed. */
+			inline void resize(uint32_t count) {
+				resizeWith(count, [](T* item) { new (item) T(); });
+			}
+
+			/* Changes the number of items. New items are copies of value and items beyond the new count are destroyed. */
+			inline void resize(uint32_t count, const T& value) {
+				const T copy(value); // value may refer to an element which is about to be destroyed or moved.
+				resizeWith(count, [&copy](T* item) { new (item) T(copy); });
+			}
+
+			inline void clear() {
+				Relocation::destroy(_first, _count);
 				_count = 0;
 			}
 
-			inline uint32_t capacity() {
+			inline uint32_t capacity() const {
 				return _capacity;
-			}			
+			}
+
+			/* Returns true if the items are stored inside the list, rather than in allocated memory. */
+			inline bool isInline() const {
+				return InlineCapacity > 0 && _first == inlineItems();
+			}
 
 			inline T& operator[] (uint32_t index) {
-				if (index >= _count || index < 0)
+				if (index >= _count)
+					throw IndexOutOfRangeExeption(index, _count);
+
+				return _first[index];
+			}
+
+			inline const T& operator[] (uint32_t index) const {
+				if (index >= _count)
 					throw IndexOutOfRangeExeption(index, _count);
 
 				return _first[index];
 			}
 
 		private:
+			uint32_t _capacity; /* Declared first, so it packs alongside Collection::_count. */
 			T* _first;
-			uint32_t _capacity;
 			FerrousAllocator* _allocator;
+
+			/* Doubles the capacity, or grows it to the required capacity if doubling is not enough. */
+			inline uint32_t getGrowthCapacity(uint32_t required) const {
+				uint32_t newCapacity = _capacity > 0 ? _capacity * 2 : 1;
+				return newCapacity < required ? required : newCapacity;
+			}
+
+			void ensureCapacity(uint32_t required) {
+				if (required <= _capacity)
+					return;
+
+				reallocate(getGrowthCapacity(required));
+			}
+
+			void reallocate(uint32_t newCapacity) {
+				T* newMem = _allocator->allocType<T>(newCapacity);
+				Relocation::relocate(newMem, _first, _count);
+				replaceMemory(newMem, newCapacity);
+			}
+
+			/*	Moves the items from index onwards back by count, growing the list if needed. Returns a pointer to the uninitialized gap,
+				which the caller must fill before increasing _count. */
+			T* openGap(uint32_t index, uint32_t count) {
+				uint32_t required = _count + count;
+				uint32_t tailCount = _count - index;
+
+				if (required > _capacity) {
+					// Relocate straight into the new memory around the gap, so no item is moved twice.
+					uint32_t newCapacity = getGrowthCapacity(required);
+					T* newMem = _allocator->allocType<T>(newCapacity);
+					Relocation::relocate(newMem, _first, index);
+					Relocation::relocate(&newMem[index + count], &_first[index], tailCount);
+					replaceMemory(newMem, newCapacity);
+				}
+				else {
+					Relocation::relocateOverlapping(&_first[index + count], &_first[index], tailCount);
+				}
+
+				return &_first[index];
+			}
+
+			template<typename Construct>
+			void resizeWith(uint32_t count, Construct construct) {
+				if (count < _count) {
+					Relocation::destroy(&_first[count], _count - count);
+				}
+				else if (count > _count) {
+					reserve(count);
+					for (uint32_t i = _count; i < count; i++)
+						construct(&_first[i]);
+				}
+
+				_count = count;
+			}
+
+			/* Releases the current memory, whose items must have already been relocated or destroyed. */
+			inline void replaceMemory(T* newMem, uint32_t newCapacity) {
+				if (_first != nullptr && !isInline())
+					_allocator->dealloc(_first);
+
+				_first = newMem;
+				_capacity = newCapacity;
+			}
+
+			/* Takes the items of other, leaving it empty. Allocated memory changes owner, but inline items must be relocated one by one. */
+			void takeFrom(List& other) {
+				_allocator = other._allocator;
+				_count = other._count;
+
+				if (other.isInline()) {
+					_first = inlineItems();
+					_capacity = InlineCapacity;
+					Relocation::relocate(_first, other._first, other._count);
+				}
+				else {
+					_first = other._first;
+					_capacity = other._capacity;
+					other._first = other.inlineItems();
+					other._capacity = InlineCapacity;
+				}
+
+				other._count = 0;
+			}
+
+			void release() {
+				Relocation::destroy(_first, _count);
+				replaceMemory(inlineItems(), InlineCapacity);
+				_count = 0;
+			}
 		};
+
+		/* A List which stores up to N items inside itself before it allocates. Suited to short lists, which then cost no allocation at all. */
+		template<typename T, uint32_t N>
+		using SmallList = List<T, N>;
 	}
 }
\ No newline at end of file
@@ -38,23 +38,21 @@ namespace fe {
 
 	Localization::Localization(const CultureInfo& defaultCulture, FerrousAllocator* allocator) {
 		_allocator = allocator;
-		_cultures = _allocator->allocType<Dictionary<FeString, Culture*>>();
-		new (_cultures) Dictionary<FeString, Culture*>(4, _allocator);
+		_cultures = _allocator->allocType<ConcurrentDictionary<FeString, Culture*>>();
+		new (_cultures) ConcurrentDictionary<FeString, Culture*>(4, _allocator);
 
 		_defaultCulture = registerCulture(defaultCulture);
 		_currentCulture = _defaultCulture;
 	}
 
 	Culture* Localization::registerCulture(const CultureInfo& info) {
-		if (_cultures->containsKey(info.EnglishName)) {
-			return (*_cultures)[info.EnglishName];
-		}
-		else {
+		// Threads registering the same culture at once all receive the one which was created first. The dictionary runs the factory
+		// under its allocator lock, since Culture allocates from Memory.
+		return _cultures->getOrAdd(info.EnglishName, [this, &info]() {
 			Culture* culture = _allocator->allocType<Culture>();
 			new (culture) Culture(info);
-			_cultures->put(info.EnglishName, culture);
 			return culture;
-		}
+		});
 	}
 
 	bool Localization::unregisterCulture(const FeString& name) {
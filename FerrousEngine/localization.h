@@ -2,7 +2,7 @@
 #include <stdint.h>
 #include "culture.h"
 #include "allocation.h"
-#include "dictionary.h"
+#include "concurrent_dictionary.h"
 
 namespace fe {
 	class Localization {
@@ -33,7 +33,7 @@ namespace fe {
 
 		Localization(const CultureInfo& defaultCulture, FerrousAllocator* allocator);
 
-		Dictionary<FeString, Culture*>* _cultures;
+		ConcurrentDictionary<FeString, Culture*>* _cultures;	/* Shared by every thread which calls Localization::get(). */
 		
 		FerrousAllocator* _allocator;
 		Culture* _currentCulture;
@@ -3,9 +3,7 @@
 #include <stdlib.h>
 
 namespace fe {
-	Logger::Logger() {
-		_outputs = List<LogOutputBase*>();
-	}
+	Logger::Logger() : _outputs() { }
 
 	Logger::~Logger() {
 		for (LogOutputBase* l : _outputs)
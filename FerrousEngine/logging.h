@@ -30,6 +30,6 @@ namespace fe {
 		void write(const FeString& msg, const Color& color = Color::white);
 
 	private:
-		List<LogOutputBase*> _outputs;
+		SmallList<LogOutputBase*, 2> _outputs;
 	};
 }
\ No newline at end of file
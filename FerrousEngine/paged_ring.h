@@ -0,0 +1,71 @@
+#pragma once
+#include "allocation.h"
+#include "bits.h"
+
+namespace fe {
+	namespace collections {
+		/*	A fixed, power-of-two number of uninitialized slots, for ring buffers which may be larger than one Memory page.
+			Slots are stored in blocks which each fit in one page, found through a table of block pointers which also fits in one page.
+			Positions wrap around the capacity. Slots are neither constructed nor destroyed; that is up to the owner. */
+		template<typename T>
+		class PagedRing {
+			static constexpr uint32_t largestPowerOfTwo(size_t limit) {
+				uint32_t value = 1;
+				while (value * 2 <= limit)
+					value *= 2;
+
+				return value;
+			}
+
+		public:
+			/* Memory::alloc() reserves room for alignment within the page, on top of the requested size. */
+			static constexpr uint32_t BLOCK_SLOTS = largestPowerOfTwo((Memory::PAGE_FREE_SIZE - FE_CACHE_LINE_SIZE - 1) / sizeof(T));
+			static constexpr uint32_t MAX_BLOCKS = largestPowerOfTwo((Memory::PAGE_FREE_SIZE - alignof(T*) - 1) / sizeof(T*));
+
+			/* The largest capacity. e.g. 131072 for 16-byte slots. */
+			static constexpr uint32_t MAX_CAPACITY = BLOCK_SLOTS * MAX_BLOCKS;
+
+			static_assert(sizeof(T) + FE_CACHE_LINE_SIZE < Memory::PAGE_FREE_SIZE, "A slot must fit in one page.");
+
+			/* capacity must be a power of two, no greater than MAX_CAPACITY. A ring which fits in one block stores its block pointer inline. */
+			PagedRing(uint32_t capacity, FerrousAllocator* allocator) {
+				assert(Bits::isPowerOfTwo(capacity) && capacity <= MAX_CAPACITY);
+
+				_mask = capacity - 1;
+				_allocator = allocator;
+				_blockCount = capacity > BLOCK_SLOTS ? capacity / BLOCK_SLOTS : 1;
+				_blocks = _blockCount == 1 ? &_singleBlock : _allocator->allocType<T*>(_blockCount);
+
+				uint32_t blockSlots = capacity < BLOCK_SLOTS ? capacity : BLOCK_SLOTS;
+				for (uint32_t b = 0; b < _blockCount; b++)
+					_blocks[b] = static_cast<T*>(_allocator->alloc(sizeof(T) * blockSlots, FE_CACHE_LINE_SIZE));
+			}
+
+			PagedRing(const PagedRing& other) = delete;
+			PagedRing& operator=(const PagedRing& other) = delete;
+
+			~PagedRing() {
+				for (uint32_t b = 0; b < _blockCount; b++)
+					_allocator->dealloc(_blocks[b]);
+
+				if (_blocks != &_singleBlock)
+					_allocator->dealloc(_blocks);
+			}
+
+			/* Returns the slot at the specified position, wrapped around the capacity. */
+			inline T& operator[] (size_t position) const {
+				size_t index = position & _mask;
+				return _blocks[index / BLOCK_SLOTS][index % BLOCK_SLOTS];
+			}
+
+			inline uint32_t capacity() const { return (uint32_t)_mask + 1; }
+
+		private:
+			T** _blocks;
+			T* _singleBlock;
+			size_t _mask;
+			uint32_t _blockCount;
+			FerrousAllocator* _allocator;
+		};
+	}
+}
\ No newline at end of file
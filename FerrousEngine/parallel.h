@@ -0,0 +1,236 @@
+#pragma once
+#include "job_system.h"
+#include "exceptions.h"
+#include "hash.h"
+#include <algorithm>
+#include <utility>
+#include <new>
+
+namespace fe {
+	namespace parallel {
+		/*	Parallel algorithms over contiguous ranges. They run on the JobSystem, and run serially when called from a thread outside it,
+			or before it is started. They may be nested: a thread waiting for its range runs other jobs, including chunks of inner ranges. */
+
+		/*	The fewest items a chunk is split down to, by default. Ranges no larger than this run serially, since below it the cost of
+			waking workers outweighs the work. Pass a smaller minGrain for expensive per-item work, or a larger one for trivial work. */
+		static constexpr uint32_t DEFAULT_MIN_GRAIN = 1024;
+
+		/* The most chunks reduce() and scan() split a range into. Their partial results are kept on the stack. */
+		static constexpr uint32_t MAX_PARTIALS = 128;
+
+		/* Chooses a chunk size which gives every thread several chunks to claim, so uneven work still balances, but never below minGrain. */
+		inline uint32_t getGrain(uint32_t count, uint32_t minGrain) {
+			uint32_t target = JobSystem::getThreadCount() * 8;
+			uint32_t grain = (uint32_t)(((uint64_t)count + target - 1) / target);
+			return grain > minGrain ? grain : (minGrain > 0 ? minGrain : 1);
+		}
+
+		/* Enables an overload for any contiguous range with data() and count(), such as a List, SmallList or Span. */
+		template<typename Range>
+		using EnableRange = decltype(std::declval<Range&>().data(), std::declval<Range&>().count());
+
+		/* Calls func(start, end) over [0, count) in chunks of exactly grain indices, except the last. */
+		template<typename Func>
+		void forRange(uint32_t count, uint32_t grain, Func&& func) {
+			JobSystem::parallelFor(count, grain, std::forward<Func>(func));
+		}
+
+		/* Calls func(item) on every item. Items may be visited in any order, and on any thread. */
+		template<typename T, typename Func>
+		void forEach(T* items, uint32_t count, Func func, uint32_t minGrain = DEFAULT_MIN_GRAIN) {
+			forRange(count, getGrain(count, minGrain), [items, &func](uint32_t start, uint32_t end) {
+				for (uint32_t i = start; i < end; i++)
+					func(items[i]);
+			});
+		}
+
+		template<typename Range, typename Func, typename = EnableRange<Range>>
+		inline void forEach(Range&& range, Func func, uint32_t minGrain = DEFAULT_MIN_GRAIN) {
+			forEach(range.data(), range.count(), func, minGrain);
+		}
+
+		/* Stores func(src[i]) in dest[i], for every item of src. dest must already hold at least count items. dest may be src. */
+		template<typename T, typename U, typename Func>
+		void transform(const T* src, U* dest, uint32_t count, Func func, uint32_t minGrain = DEFAULT_MIN_GRAIN) {
+			forRange(count, getGrain(count, minGrain), [src, dest, &func](uint32_t start, uint32_t end) {
+				for (uint32_t i = start; i < end; i++)
+					dest[i] = func(src[i]);
+			});
+		}
+
+		/* Stores func(src[i]) in dest[i], for every item of src. Throws if dest holds fewer items than src; resize() a List first. */
+		template<typename SrcRange, typename DestRange, typename Func, typename = EnableRange<SrcRange>, typename = EnableRange<DestRange>>
+		inline void transform(const SrcRange& src, DestRange&& dest, Func func, uint32_t minGrain = DEFAULT_MIN_GRAIN) {
+			if (dest.count() < src.count())
+				throw IndexOutOfRangeExeption(src.count(), dest.count());
+
+			transform(src.data(), dest.data(), src.count(), func, minGrain);
+		}
+
+		/* Per-chunk results of reduce() and scan(). Widens the grain when needed, so the range is split into at most MAX_PARTIALS chunks. */
+		template<typename T>
+		struct PartialResults {
+			uint32_t grain;
+			uint32_t count;
+
+			PartialResults(uint32_t itemCount, uint32_t minGrain) {
+				uint32_t leastGrain = (itemCount + MAX_PARTIALS - 1) / MAX_PARTIALS;
+				grain = minGrain > leastGrain ? minGrain : leastGrain;
+				count = (itemCount + grain - 1) / grain;
+
+				for (uint32_t c = 0; c < count; c++)
+					_constructed[c] = false;
+			}
+
+			~PartialResults() {
+				for (uint32_t c = 0; c < count; c++) {
+					if (_constructed[c])
+						items()[c].~T();
+				}
+			}
+
+			PartialResults(const PartialResults& other) = delete;
+			PartialResults& operator=(const PartialResults& other) = delete;
+
+			/* Stores the result of the chunk which starts at the specified index. */
+			inline void set(uint32_t start, T&& value) {
+				uint32_t c = start / grain;
+				new (&items()[c]) T(std::move(value));
+				_constructed[c] = true;
+			}
+
+			inline T& operator[] (uint32_t c) { return items()[c]; }
+
+		private:
+			alignas(T) unsigned char _storage[sizeof(T) * MAX_PARTIALS];
+			bool _constructed[MAX_PARTIALS];
+
+			inline T* items() { return reinterpret_cast<T*>(_storage); }
+		};
+
+		/*	Combines every item with op, starting from init. op must be associative, since chunks are reduced separately and then combined
+			in order; it need not be commutative. e.g. float total = parallel::reduce(weights, 0.0f, [](float a, float b) { return a + b; }); */
+		template<typename T, typename Op>
+		T reduce(const T* items, uint32_t count, T init, Op op, uint32_t minGrain = DEFAULT_MIN_GRAIN) {
+			uint32_t grain = getGrain(count, minGrain);
+			if (count <= grain) {
+				for (uint32_t i = 0; i < count; i++)
+					init = op(init, items[i]);
+
+				return init;
+			}
+
+			PartialResults<T> partials(count, grain);
+			forRange(count, partials.grain, [items, &op, &partials](uint32_t start, uint32_t end) {
+				T value(items[start]);
+				for (uint32_t i = start + 1; i < end; i++)
+					value = op(value, items[i]);
+
+				partials.set(start, std::move(value));
+			});
+
+			for (uint32_t c = 0; c < partials.count; c++)
+				init = op(init, partials[c]);
+
+			return init;
+		}
+
+		template<typename Range, typename T, typename Op, typename = EnableRange<Range>>
+		inline T reduce(const Range& range, T init, Op op, uint32_t minGrain = DEFAULT_MIN_GRAIN) {
+			return reduce(range.data(), range.count(), std::move(init), op, minGrain);
+		}
+
+		/*	Stores the inclusive prefix of src in dest, so dest[i] = src[0] op src[1] op ... op src[i]. dest may be src. op must be associative.
+			Runs in two parallel passes: one totals each chunk, and the second scans each chunk starting from the total of the chunks before it. */
+		template<typename T, typename Op>
+		void scan(const T* src, T* dest, uint32_t count, Op op, uint32_t minGrain = DEFAULT_MIN_GRAIN) {
+			if (count == 0)
+				return;
+
+			uint32_t grain = getGrain(count, minGrain);
+			if (count <= grain) {
+				T value(src[0]);
+				dest[0] = value;
+				for (uint32_t i = 1; i < count; i++) {
+					value = op(value, src[i]);
+					dest[i] = value;
+				}
+
+				return;
+			}
+
+			PartialResults<T> partials(count, grain);
+			forRange(count, partials.grain, [src, &op, &partials](uint32_t start, uint32_t end) {
+				T value(src[start]);
+				for (uint32_t i = start + 1; i < end; i++)
+					value = op(value, src[i]);
+
+				partials.set(start, std::move(value));
+			});
+
+			// Replace each chunk's total with the total of every chunk before it. The first chunk has none, and starts from its first item.
+			T running(partials[0]);
+			for (uint32_t c = 1; c < partials.count; c++) {
+				T next = op(running, partials[c]);
+				partials[c] = std::move(running);
+				running = std::move(next);
+			}
+
+			forRange(count, partials.grain, [src, dest, &op, &partials](uint32_t start, uint32_t end) {
+				T value = start == 0 ? T(src[0]) : op(partials[start / partials.grain], src[start]);
+				dest[start] = value;
+				for (uint32_t i = start + 1; i < end; i++) {
+					value = op(value, src[i]);
+					dest[i] = value;
+				}
+			});
+		}
+
+		template<typename SrcRange, typename DestRange, typename Op, typename = EnableRange<SrcRange>, typename = EnableRange<DestRange>>
+		inline void scan(const SrcRange& src, DestRange&& dest, Op op, uint32_t minGrain = DEFAULT_MIN_GRAIN) {
+			if (dest.count() < src.count())
+				throw IndexOutOfRangeExeption(src.count(), dest.count());
+
+			scan(src.data(), dest.data(), src.count(), op, minGrain);
+		}
+
+		/*	Sorts items with less. Not stable. Runs of items are sorted in parallel, then merged pairwise in parallel rounds. The final round
+			is a single merge of two halves, so sort() scales less well than the other algorithms. */
+		template<typename T, typename Less = collections::DefaultKeyLess<T>>
+		void sort(T* items, uint32_t count, Less less = Less(), uint32_t minGrain = DEFAULT_MIN_GRAIN) {
+			uint32_t runSize = getGrain(count, minGrain);
+			if (count <= runSize) {
+				std::sort(items, items + count, less);
+				return;
+			}
+
+			uint32_t runCount = (count + runSize - 1) / runSize;
+			forRange(runCount, 1, [items, count, runSize, &less](uint32_t start, uint32_t end) {
+				for (uint32_t run = start; run < end; run++) {
+					uint32_t first = run * runSize;
+					uint32_t last = std::min<uint32_t>(first + runSize, count);
+					std::sort(items + first, items + last, less);
+				}
+			});
+
+			for (uint64_t width = runSize; width < count; width *= 2) {
+				uint32_t pairCount = (uint32_t)((count + width * 2 - 1) / (width * 2));
+				forRange(pairCount, 1, [items, count, width, &less](uint32_t start, uint32_t end) {
+					for (uint32_t pair = start; pair < end; pair++) {
+						uint64_t first = pair * width * 2;
+						uint64_t middle = std::min<uint64_t>(first + width, count);
+						uint64_t last = std::min<uint64_t>(first + width * 2, count);
+						if (middle < last)
+							std::inplace_merge(items + first, items + middle, items + last, less);
+					}
+				});
+			}
+		}
+
+		template<typename Range, typename Less = collections::DefaultKeyLess<std::remove_pointer_t<decltype(std::declval<Range&>().data())>>,
+			typename = EnableRange<Range>>
+		inline void sort(Range&& range, Less less = Less(), uint32_t minGrain = DEFAULT_MIN_GRAIN) {
+			sort(range.data(), range.count(), less, minGrain);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,228 @@
+#pragma once
+#include "list.h"
+#include "slot_map.h"
+#include "hash.h"
+
+namespace fe {
+	namespace collections {
+		/*	A priority queue, stored as a D-ary heap in a contiguous List. The item which C orders first (the lowest, by default) is at the top.
+			A D of 4 halves the depth of a binary heap, and a node's children are adjacent, so they usually share a cache line.
+			Every item gets a SlotHandle, which can later be used to change its priority (e.g. decrease-key in A*) or remove it.
+			e.g. SlotHandle timer = timers.push(Timer{ dueTime, callback }); timers.update(timer, Timer{ newDueTime, callback }); */
+		template<typename T, typename C = DefaultKeyLess<T>, uint32_t D = 4>
+		class PriorityQueue {
+			static_assert(D >= 2, "A heap must have at least two children per node.");
+
+			struct Entry {
+				T item;
+				SlotHandle handle;
+			};
+
+		public:
+			PriorityQueue(uint32_t initialCapacity = 0, FerrousAllocator* allocator = Memory::get()) :
+				_heap(initialCapacity, allocator), _positions(initialCapacity, allocator) { }
+
+			/* Builds a queue from count items in O(count), rather than pushing them one by one. */
+			PriorityQueue(const T* items, uint32_t count, FerrousAllocator* allocator = Memory::get()) :
+				_heap(count, allocator), _positions(count, allocator) {
+				pushRange(items, count);
+			}
+
+			inline SlotHandle push(const T& item) { return emplace(item); }
+			inline SlotHandle push(T&& item) { return emplace(std::move(item)); }
+
+			template<typename... Args>
+			SlotHandle emplace(Args&&... args) {
+				uint32_t index = _heap.count();
+				SlotHandle handle = _positions.add(index);
+				_heap.emplace(Entry{ T(std::forward<Args>(args)...), handle });
+				siftUp(index);
+				return handle;
+			}
+
+			/*	Adds count items, then restores the heap bottom-up (Floyd's method), which is O(n) instead of O(n log n).
+				If handles is not null, it receives the handle of each item, in order. */
+			void pushRange(const T* items, uint32_t count, SlotHandle* handles = nullptr) {
+				_heap.reserve(_heap.count() + count);
+
+				for (uint32_t i = 0; i < count; i++) {
+					SlotHandle handle = _positions.add(_heap.count());
+					_heap.add(Entry{ items[i], handle });
+					if (handles != nullptr)
+						handles[i] = handle;
+				}
+
+				uint32_t heapCount = _heap.count();
+				if (heapCount > 1) {
+					for (uint32_t i = getParent(heapCount - 1) + 1; i-- > 0;)
+						siftDown(i);
+				}
+			}
+
+			/* Returns the item at the top of the queue. */
+			inline const T& top() const {
+				return _heap[0].item;
+			}
+
+			/* Removes and returns the item at the top of the queue. */
+			T pop() {
+				if (_heap.count() == 0)
+					throw IndexOutOfRangeExeption(0, 0);
+
+				T item = std::move(_heap[0].item);
+				removeAtPosition(0);
+				return item;
+			}
+
+			/* Removes the item at the top of the queue into item. Returns false if the queue is empty. */
+			bool tryPop(T& item) {
+				if (_heap.count() == 0)
+					return false;
+
+				item = std::move(_heap[0].item);
+				removeAtPosition(0);
+				return true;
+			}
+
+			/* Replaces the item referred to by handle, and moves it to its new place in the queue. Returns false if the handle is no longer valid. */
+			bool update(SlotHandle handle, const T& item) {
+				uint32_t* position = _positions.tryGet(handle);
+				if (position == nullptr)
+					return false;
+
+				uint32_t index = *position;
+				bool movesUp = _compare(item, _heap[index].item);
+				_heap[index].item = item;
+
+				if (movesUp)
+					siftUp(index);
+				else
+					siftDown(index);
+
+				return true;
+			}
+
+			/* Same as update(), for an item which C orders no later than the one it replaces, such as a shorter path cost. Only sifts up. */
+			bool decreaseKey(SlotHandle handle, const T& item) {
+				uint32_t* position = _positions.tryGet(handle);
+				if (position == nullptr)
+					return false;
+
+				assert(!_compare(_heap[*position].item, item));
+				_heap[*position].item = item;
+				siftUp(*position);
+				return true;
+			}
+
+			/* Removes the item referred to by handle. Returns false if the handle is no longer valid. */
+			bool remove(SlotHandle handle) {
+				uint32_t* position = _positions.tryGet(handle);
+				if (position == nullptr)
+					return false;
+
+				removeAtPosition(*position);
+				return true;
+			}
+
+			/* Returns true if handle refers to an item which is still in the queue. */
+			inline bool contains(SlotHandle handle) const {
+				return _positions.contains(handle);
+			}
+
+			/* Returns the item referred to by handle. Throws if the handle is no longer valid. */
+			inline const T& get(SlotHandle handle) const {
+				return _heap[_positions.get(handle)].item;
+			}
+
+			void clear() {
+				_heap.clear();
+				_positions.clear();
+			}
+
+			inline void reserve(uint32_t capacity) {
+				_heap.reserve(capacity);
+				_positions.reserve(capacity);
+			}
+
+			inline uint32_t count() const { return _heap.count(); }
+			inline bool isEmpty() const { return _heap.count() == 0; }
+
+		private:
+			List<Entry> _heap;
+			SlotMap<uint32_t> _positions;	/* The heap index of each handle's item. */
+			C _compare;
+
+			static inline uint32_t getParent(uint32_t index) {
+				return (index - 1) / D;
+			}
+
+			/* Moves the entry into place, and records its new position against its handle. */
+			inline void place(uint32_t index, Entry&& entry) {
+				_positions.get(entry.handle) = index;
+				_heap[index] = std::move(entry);
+			}
+
+			/* Moves the item at index towards the top until its parent is ordered before it. Parents are shifted down into the hole. */
+			void siftUp(uint32_t index) {
+				Entry entry = std::move(_heap[index]);
+
+				while (index > 0) {
+					uint32_t parent = getParent(index);
+					if (!_compare(entry.item, _heap[parent].item))
+						break;
+
+					place(index, std::move(_heap[parent]));
+					index = parent;
+				}
+
+				place(index, std::move(entry));
+			}
+
+			/* Moves the item at index towards the bottom until no child is ordered before it. The first child is promoted into the hole. */
+			void siftDown(uint32_t index) {
+				uint32_t heapCount = _heap.count();
+				Entry entry = std::move(_heap[index]);
+
+				for (;;) {
+					uint32_t firstChild = index * D + 1;
+					if (firstChild >= heapCount)
+						break;
+
+					uint32_t lastChild = firstChild + D < heapCount ? firstChild + D : heapCount;
+					uint32_t best = firstChild;
+					for (uint32_t child = firstChild + 1; child < lastChild; child++) {
+						if (_compare(_heap[child].item, _heap[best].item))
+							best = child;
+					}
+
+					if (!_compare(_heap[best].item, entry.item))
+						break;
+
+					place(index, std::move(_heap[best]));
+					index = best;
+				}
+
+				place(index, std::move(entry));
+			}
+
+			/* Fills the position with the last entry, then restores the heap from there. */
+			void removeAtPosition(uint32_t index) {
+				_positions.remove(_heap[index].handle);
+
+				uint32_t last = _heap.count() - 1;
+				if (index != last) {
+					_heap[index] = std::move(_heap[last]);
+					_heap.removeAt(last);
+
+					if (index > 0 && _compare(_heap[index].item, _heap[getParent(index)].item))
+						siftUp(index);
+					else
+						siftDown(index);
+				}
+				else {
+					_heap.removeAt(last);
+				}
+			}
+		};
+	}
+}
\ No newline at end of file
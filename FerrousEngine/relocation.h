@@ -0,0 +1,77 @@
+#pragma once
+#include "stdafx.h"
+#include <type_traits>
+#include <utility>
+#include <new>
+
+namespace fe {
+	namespace collections {
+		/*	True if an object can be moved to a new address by copying its bytes, without calling its move constructor or destructor.
+			Defaults to trivially-copyable types. Specialize it for types which own memory but never point into themselves (e.g. FeString). */
+		template<typename T>
+		struct IsTriviallyRelocatable : std::is_trivially_copyable<T> {};
+
+		/* Helpers for moving and destroying arrays of objects in raw (allocator-provided) memory. */
+		class Relocation {
+		public:
+			/* Moves count objects from src into uninitialized memory at dest, then destroys the originals. The ranges must not overlap. */
+			template<typename T>
+			static inline void relocate(T* dest, T* src, const uint32_t count) {
+				if constexpr (IsTriviallyRelocatable<T>::value) {
+					if (count > 0)
+						memcpy(static_cast<void*>(dest), src, sizeof(T) * count);
+				}
+				else {
+					for (uint32_t i = 0; i < count; i++) {
+						new (&dest[i]) T(std::move(src[i]));
+						src[i].~T();
+					}
+				}
+			}
+
+			/* Same as relocate(), but the ranges may overlap. Used to shift elements along the same array. */
+			template<typename T>
+			static inline void relocateOverlapping(T* dest, T* src, const uint32_t count) {
+				if constexpr (IsTriviallyRelocatable<T>::value) {
+					if (count > 0)
+						memmove(static_cast<void*>(dest), src, sizeof(T) * count);
+				}
+				else if (dest < src) {
+					for (uint32_t i = 0; i < count; i++) {
+						new (&dest[i]) T(std::move(src[i]));
+						src[i].~T();
+					}
+				}
+				else if (dest > src) {
+					// Start from the end, so no element is overwritten before it has been moved.
+					for (uint32_t i = count; i > 0; i--) {
+						new (&dest[i - 1]) T(std::move(src[i - 1]));
+						src[i - 1].~T();
+					}
+				}
+			}
+
+			/* Copy-constructs count objects from src into uninitialized memory at dest. */
+			template<typename T>
+			static inline void copy(T* dest, const T* src, const uint32_t count) {
+				if constexpr (std::is_trivially_copyable<T>::value) {
+					if (count > 0)
+						memcpy(static_cast<void*>(dest), src, sizeof(T) * count);
+				}
+				else {
+					for (uint32_t i = 0; i < count; i++)
+						new (&dest[i]) T(src[i]);
+				}
+			}
+
+			/* Calls the destructor of count objects. Does nothing for trivially-destructible types. */
+			template<typename T>
+			static inline void destroy(T* first, const uint32_t count) {
+				if constexpr (!std::is_trivially_destructible<T>::value) {
+					for (uint32_t i = 0; i < count; i++)
+						first[i].~T();
+				}
+			}
+		};
+	}
+}
\ No newline at end of file
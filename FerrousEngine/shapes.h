@@ -1,3 +1,4 @@
 #pragma once
 #include "shapes_setup.h"
-#include "shapes_common.h"
\ No newline at end of file
+#include "shapes_common.h"
+#include "shapes_hash.h"
\ No newline at end of file
@@ -0,0 +1,48 @@
+#pragma once
+#include "shapes_common.h"
+#include "hash.h"
+
+// DefaultKeyHash specializations for glm vectors and shapes, so they can be used as dictionary keys.
+namespace fe {
+	namespace collections {
+		template <glm::length_t L, typename T, glm::qualifier Q>
+		struct DefaultKeyHash<glm::vec<L, T, Q>> {
+			uint64_t operator()(const glm::vec<L, T, Q>& key) const {
+				DefaultKeyHash<T> hashComponent;
+				uint64_t result = hashComponent(key[0]);
+				for (glm::length_t i = 1; i < L; i++)
+					result = Hash::combine(result, hashComponent(key[i]));
+
+				return result;
+			}
+		};
+
+		template <typename T, glm::qualifier Q>
+		struct DefaultKeyHash<shapes::Rect<T, Q>> {
+			uint64_t operator()(const shapes::Rect<T, Q>& key) const {
+				return Hash::of(key.left, key.top, key.right, key.bottom);
+			}
+		};
+
+		template <typename T, glm::qualifier Q>
+		struct DefaultKeyHash<shapes::Circle<T, Q>> {
+			uint64_t operator()(const shapes::Circle<T, Q>& key) const {
+				return Hash::of(key.origin, key.radius);
+			}
+		};
+
+		template <typename T, glm::qualifier Q>
+		struct DefaultKeyHash<shapes::Line<T, Q>> {
+			uint64_t operator()(const shapes::Line<T, Q>& key) const {
+				return Hash::of(key.start, key.end);
+			}
+		};
+
+		template <typename T, glm::qualifier Q>
+		struct DefaultKeyHash<shapes::Triangle<T, Q>> {
+			uint64_t operator()(const shapes::Triangle<T, Q>& key) const {
+				return Hash::of(key.a, key.b, key.c);
+			}
+		};
+	}
+}
\ No newline at end of file
@@ -0,0 +1,187 @@
+#pragma once
+#include "list.h"
+#include "span.h"
+
+namespace fe {
+	namespace collections {
+		/*	A 32-bit handle to an item in a SlotMap. The low bits hold the slot index and the high bits hold the slot's generation,
+			which changes whenever the slot's item is removed, so a handle to a removed item is detected instead of silently reaching
+			whichever item reused the slot. A default-constructed handle is never valid. */
+		struct SlotHandle {
+			static constexpr uint32_t INDEX_BITS = 20;
+			static constexpr uint32_t GENERATION_BITS = 32 - INDEX_BITS;
+			static constexpr uint32_t INDEX_MASK = (1U << INDEX_BITS) - 1;
+			static constexpr uint32_t GENERATION_MASK = (1U << GENERATION_BITS) - 1;
+
+			/* The largest number of slots a SlotMap can hold. */
+			static constexpr uint32_t MAX_SLOTS = 1U << INDEX_BITS;
+
+			SlotHandle() : value(0) { }
+
+			SlotHandle(uint32_t index, uint32_t generation) : value((generation << INDEX_BITS) | index) { }
+
+			inline uint32_t index() const { return value & INDEX_MASK; }
+			inline uint32_t generation() const { return value >> INDEX_BITS; }
+
+			inline bool operator ==(const SlotHandle& other) const { return value == other.value; }
+			inline bool operator !=(const SlotHandle& other) const { return value != other.value; }
+
+			uint32_t value;
+		};
+
+		/*	Stores items in one dense, contiguous array and hands out SlotHandles to them. Insertion, removal and lookup are O(1),
+			and handles stay valid when other items are removed. Removing an item moves the last item into its place, so iteration
+			is a linear walk over the dense array, in no particular order.
+			e.g. SlotHandle h = entities.add(entity); entities.get(h).update(); entities.remove(h); */
+		template<typename T>
+		class SlotMap {
+			struct Slot {
+				uint32_t denseIndex;	/* Index of the item in the dense array, or of the next free slot if the slot is free. */
+				uint32_t generation;
+			};
+
+			static constexpr uint32_t NO_FREE_SLOT = UINT32_MAX;
+
+		public:
+			using iterator = typename List<T>::iterator;
+			using const_iterator = typename List<T>::const_iterator;
+
+			SlotMap(uint32_t initialCapacity = 0, FerrousAllocator* allocator = Memory::get()) :
+				_items(initialCapacity, allocator),
+				_itemSlots(initialCapacity, allocator),
+				_slots(initialCapacity, allocator),
+				_freeSlot(NO_FREE_SLOT) { }
+
+			inline iterator begin() { return _items.begin(); }
+			inline iterator end() { return _items.end(); }
+			inline const_iterator begin() const { return _items.begin(); }
+			inline const_iterator end() const { return _items.end(); }
+
+			inline SlotHandle add(const T& item) { return emplace(item); }
+			inline SlotHandle add(T&& item) { return emplace(std::move(item)); }
+
+			/* Constructs an item in place and returns its handle. */
+			template<typename... Args>
+			SlotHandle emplace(Args&&... args) {
+				uint32_t slotIndex = _freeSlot;
+				if (slotIndex == NO_FREE_SLOT) {
+					assert(_slots.count() < SlotHandle::MAX_SLOTS);
+					slotIndex = _slots.count();
+					_slots.add(Slot{ 0, 1 });
+				}
+
+				_items.emplace(std::forward<Args>(args)...);
+				_itemSlots.add(slotIndex);
+
+				Slot& slot = _slots[slotIndex];
+				if (slotIndex == _freeSlot)
+					_freeSlot = slot.denseIndex;
+
+				slot.denseIndex = _items.count() - 1;
+				return SlotHandle(slotIndex, slot.generation);
+			}
+
+			/* Removes the item referred to by handle. Returns false if the handle is no longer valid. */
+			bool remove(SlotHandle handle) {
+				if (!contains(handle))
+					return false;
+
+				Slot& slot = _slots[handle.index()];
+				uint32_t denseIndex = slot.denseIndex;
+				uint32_t lastIndex = _items.count() - 1;
+
+				// The last item moves into the removed item's place, so its slot must follow it.
+				if (denseIndex != lastIndex) {
+					_slots[_itemSlots[lastIndex]].denseIndex = denseIndex;
+					_itemSlots[denseIndex] = _itemSlots[lastIndex];
+				}
+
+				_items.swapRemove(denseIndex);
+				_itemSlots.swapRemove(lastIndex);
+				freeSlot(handle.index());
+				return true;
+			}
+
+			/* Returns true if handle refers to an item which has not been removed. */
+			inline bool contains(SlotHandle handle) const {
+				uint32_t index = handle.index();
+				return index < _slots.count() && _slots[index].generation == handle.generation();
+			}
+
+			/* Returns the item referred to by handle. Throws if the handle is no longer valid. */
+			inline T& get(SlotHandle handle) {
+				if (!contains(handle))
+					throw "Slot handle is not valid.";
+
+				return _items[_slots[handle.index()].denseIndex];
+			}
+
+			inline const T& get(SlotHandle handle) const {
+				if (!contains(handle))
+					throw "Slot handle is not valid.";
+
+				return _items[_slots[handle.index()].denseIndex];
+			}
+
+			/* Returns a pointer to the item referred to by handle, or nullptr if the handle is no longer valid.
+				The pointer is invalidated by the next add or remove. */
+			inline T* tryGet(SlotHandle handle) {
+				return contains(handle) ? &_items[_slots[handle.index()].denseIndex] : nullptr;
+			}
+
+			inline const T* tryGet(SlotHandle handle) const {
+				return contains(handle) ? &_items[_slots[handle.index()].denseIndex] : nullptr;
+			}
+
+			/* Returns the handle of the item at the specified index of the dense array. */
+			inline SlotHandle handleAt(uint32_t denseIndex) const {
+				uint32_t slotIndex = _itemSlots[denseIndex];
+				return SlotHandle(slotIndex, _slots[slotIndex].generation);
+			}
+
+			/* Returns a span over the dense array of items. */
+			inline Span<T> items() { return Span<T>(_items.data(), _items.count()); }
+			inline Span<const T> items() const { return Span<const T>(_items.data(), _items.count()); }
+
+			/* Removes every item. All existing handles become invalid. */
+			void clear() {
+				for (uint32_t slotIndex : _itemSlots)
+					freeSlot(slotIndex);
+
+				_items.clear();
+				_itemSlots.clear();
+			}
+
+			inline void reserve(uint32_t capacity) {
+				_items.reserve(capacity);
+				_itemSlots.reserve(capacity);
+				_slots.reserve(capacity);
+			}
+
+			inline T& operator[] (SlotHandle handle) { return get(handle); }
+			inline const T& operator[] (SlotHandle handle) const { return get(handle); }
+
+			inline uint32_t count() const { return _items.count(); }
+			inline bool isEmpty() const { return _items.count() == 0; }
+
+		private:
+			List<T> _items;					/* The dense array. */
+			List<uint32_t> _itemSlots;		/* The slot index of each item in the dense array. */
+			List<Slot> _slots;
+			uint32_t _freeSlot;				/* Head of the list of free slots, linked through Slot::denseIndex. */
+
+			/* Invalidates every handle to the slot, and pushes it onto the free list. */
+			inline void freeSlot(uint32_t slotIndex) {
+				Slot& slot = _slots[slotIndex];
+
+				// Generation 0 is skipped, so that a default-constructed handle never matches a slot.
+				slot.generation = (slot.generation + 1) & SlotHandle::GENERATION_MASK;
+				if (slot.generation == 0)
+					slot.generation = 1;
+
+				slot.denseIndex = _freeSlot;
+				_freeSlot = slotIndex;
+			}
+		};
+	}
+}
\ No newline at end of file
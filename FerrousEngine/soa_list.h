@@ -0,0 +1,366 @@
+#pragma once
+#include "allocation.h"
+#include "exceptions.h"
+#include "relocation.h"
+#include "span.h"
+#include <tuple>
+#include <initializer_list>
+#include <utility>
+
+namespace fe {
+	namespace collections {
+		/*	A structure-of-arrays list. Each field is stored in its own contiguous, aligned column, so a pass which only touches some
+			fields streams only those fields through the cache, and can be vectorized. All columns share one allocation.
+			e.g. SoAList<vec2, vec2, float> particles; particles.add(position, velocity, lifetime); for (vec2& p : particles.field<0>()) ... */
+		template<typename... Fields>
+		class SoAList {
+			static_assert(sizeof...(Fields) > 0, "An SoAList requires at least one field.");
+
+			using Columns = std::tuple<Fields*...>;
+			using Indices = std::index_sequence_for<Fields...>;
+
+			static constexpr size_t getColumnAlignment() {
+				size_t result = 16;
+				for (size_t alignment : { alignof(Fields)... }) {
+					if (alignment > result)
+						result = alignment;
+				}
+
+				return result;
+			}
+
+		public:
+			static constexpr size_t FIELD_COUNT = sizeof...(Fields);
+
+			/* Columns are aligned to at least 16 bytes, so they can be processed with aligned SIMD loads. */
+			static constexpr size_t COLUMN_ALIGNMENT = getColumnAlignment();
+
+			template<size_t I>
+			using FieldType = std::tuple_element_t<I, std::tuple<Fields...>>;
+
+			/* A row of references to the fields of one item. Works with structured bindings. e.g. auto [position, velocity] = list[i]; */
+			using Row = std::tuple<Fields&...>;
+			using ConstRow = std::tuple<const Fields&...>;
+
+			template<bool IsConst>
+			class RowIterator {
+				using Owner = std::conditional_t<IsConst, const SoAList, SoAList>;
+
+			public:
+				using value_type = std::tuple<Fields...>;
+				using reference = std::conditional_t<IsConst, ConstRow, Row>;
+				using pointer = void;
+				using difference_type = std::ptrdiff_t;
+				using iterator_category = std::forward_iterator_tag;
+
+				RowIterator(Owner* owner, uint32_t index) : _owner(owner), _index(index) { }
+
+				inline reference operator*() const { return (*_owner)[_index]; }
+
+				inline RowIterator& operator++() {
+					_index++;
+					return *this;
+				}
+
+				inline bool operator ==(const RowIterator& other) const { return _index == other._index; }
+				inline bool operator !=(const RowIterator& other) const { return _index != other._index; }
+
+			private:
+				Owner* _owner;
+				uint32_t _index;
+			};
+
+			SoAList(uint32_t initialCapacity = 0, FerrousAllocator* allocator = Memory::get()) {
+				_memory = nullptr;
+				_count = 0;
+				_capacity = 0;
+				_allocator = allocator;
+
+				if (initialCapacity > 0)
+					reserve(initialCapacity);
+			}
+
+			SoAList(const SoAList& other) : SoAList(other._count, other._allocator) {
+				copyColumns(other, Indices());
+				_count = other._count;
+			}
+
+			SoAList(SoAList&& other) noexcept {
+				takeFrom(other);
+			}
+
+			~SoAList() {
+				release();
+			}
+
+			SoAList& operator=(const SoAList& other) {
+				if (this != &other) {
+					clear();
+					reserve(other._count);
+					copyColumns(other, Indices());
+					_count = other._count;
+				}
+
+				return *this;
+			}
+
+			SoAList& operator=(SoAList&& other) noexcept {
+				if (this != &other) {
+					release();
+					takeFrom(other);
+				}
+
+				return *this;
+			}
+
+			inline RowIterator<false> begin() { return RowIterator<false>(this, 0); }
+			inline RowIterator<false> end() { return RowIterator<false>(this, _count); }
+			inline RowIterator<true> begin() const { return RowIterator<true>(this, 0); }
+			inline RowIterator<true> end() const { return RowIterator<true>(this, _count); }
+
+			/* Adds an item. One value must be provided per field, in order. Each field is constructed from its value. */
+			template<typename... Args>
+			void add(Args&&... values) {
+				static_assert(sizeof...(Args) == FIELD_COUNT, "add() requires one value per field.");
+
+				if (_count == _capacity) {
+					// Construct the new item before relocating, in case the values refer to an existing item.
+					uint32_t newCapacity = _capacity > 0 ? _capacity * 2 : 4;
+					Columns newColumns;
+					void* newMemory = allocateColumns(newCapacity, newColumns);
+					constructRow(newColumns, _count, Indices(), std::forward<Args>(values)...);
+					replaceColumns(newMemory, newColumns, newCapacity);
+				}
+				else {
+					constructRow(_columns, _count, Indices(), std::forward<Args>(values)...);
+				}
+
+				_count++;
+			}
+
+			/* Inserts an item at the specified index, moving later items back by one. One value must be provided per field, in order. */
+			template<typename... Args>
+			void insert(uint32_t index, Args&&... values) {
+				static_assert(sizeof...(Args) == FIELD_COUNT, "insert() requires one value per field.");
+
+				if (index > _count)
+					throw IndexOutOfRangeExeption(index, _count);
+
+				if (_count == _capacity) {
+					// Relocate straight into the new columns around the gap, so no item is moved twice.
+					uint32_t newCapacity = _capacity > 0 ? _capacity * 2 : 4;
+					Columns newColumns;
+					void* newMemory = allocateColumns(newCapacity, newColumns);
+					constructRow(newColumns, index, Indices(), std::forward<Args>(values)...);
+					relocateAroundGap(newColumns, index, Indices());
+
+					if (_memory != nullptr)
+						_allocator->dealloc(_memory);
+
+					_memory = newMemory;
+					_columns = newColumns;
+					_capacity = newCapacity;
+				}
+				else {
+					// Construct the item first, in case the values refer to one of the items about to move.
+					std::tuple<Fields...> row(std::forward<Args>(values)...);
+					forEachColumn([this, index](auto* column) {
+						Relocation::relocateOverlapping(&column[index + 1], &column[index], _count - index);
+					});
+					moveRow(row, index, Indices());
+				}
+
+				_count++;
+			}
+
+			/* Removes the item at the specified index, moving later items forward by one. */
+			void removeAt(uint32_t index) {
+				if (index >= _count)
+					throw IndexOutOfRangeExeption(index, _count);
+
+				forEachColumn([this, index](auto* column) {
+					Relocation::destroy(&column[index], 1);
+					Relocation::relocateOverlapping(&column[index], &column[index + 1], _count - (index + 1));
+				});
+
+				_count--;
+			}
+
+			/* Removes the item at the specified index by moving the last item into its place. Does not preserve order. */
+			void swapRemove(uint32_t index) {
+				if (index >= _count)
+					throw IndexOutOfRangeExeption(index, _count);
+
+				_count--;
+				forEachColumn([this, index](auto* column) {
+					Relocation::destroy(&column[index], 1);
+					if (index != _count)
+						Relocation::relocate(&column[index], &column[_count], 1);
+				});
+			}
+
+			/* Ensures the list can hold at least the specified number of items without reallocating. */
+			void reserve(uint32_t capacity) {
+				if (capacity <= _capacity)
+					return;
+
+				Columns newColumns;
+				void* newMemory = allocateColumns(capacity, newColumns);
+				replaceColumns(newMemory, newColumns, capacity);
+			}
+
+			void clear() {
+				forEachColumn([this](auto* column) {
+					Relocation::destroy(column, _count);
+				});
+
+				_count = 0;
+			}
+
+			/* Returns a span over every value of the field at index I. */
+			template<size_t I>
+			inline Span<FieldType<I>> field() {
+				return Span<FieldType<I>>(std::get<I>(_columns), _count);
+			}
+
+			template<size_t I>
+			inline Span<const FieldType<I>> field() const {
+				return Span<const FieldType<I>>(std::get<I>(_columns), _count);
+			}
+
+			/* Returns the field at index I, of the item at the specified index. */
+			template<size_t I>
+			inline FieldType<I>& get(uint32_t index) {
+				if (index >= _count)
+					throw IndexOutOfRangeExeption(index, _count);
+
+				return std::get<I>(_columns)[index];
+			}
+
+			template<size_t I>
+			inline const FieldType<I>& get(uint32_t index) const {
+				if (index >= _count)
+					throw IndexOutOfRangeExeption(index, _count);
+
+				return std::get<I>(_columns)[index];
+			}
+
+			inline Row operator[] (uint32_t index) {
+				if (index >= _count)
+					throw IndexOutOfRangeExeption(index, _count);
+
+				return getRow<Row>(index, Indices());
+			}
+
+			inline ConstRow operator[] (uint32_t index) const {
+				if (index >= _count)
+					throw IndexOutOfRangeExeption(index, _count);
+
+				return getRow<ConstRow>(index, Indices());
+			}
+
+			inline uint32_t count() const { return _count; }
+			inline uint32_t capacity() const { return _capacity; }
+			inline bool isEmpty() const { return _count == 0; }
+
+		private:
+			Columns _columns;
+			void* _memory;		/* A single allocation holding every column, one after the other. */
+			uint32_t _count;
+			uint32_t _capacity;
+			FerrousAllocator* _allocator;
+
+			template<typename Func>
+			inline void forEachColumn(Func func) {
+				std::apply([&func](auto*... columns) { (func(columns), ...); }, _columns);
+			}
+
+			static inline size_t alignColumnSize(size_t numBytes) {
+				return (numBytes + COLUMN_ALIGNMENT - 1) & ~(COLUMN_ALIGNMENT - 1);
+			}
+
+			/* Allocates one block for every column at the provided capacity, and stores the start of each column in columns. */
+			void* allocateColumns(uint32_t capacity, Columns& columns) {
+				constexpr size_t sizes[] = { sizeof(Fields)... };
+				size_t totalBytes = 0;
+				for (size_t size : sizes)
+					totalBytes += alignColumnSize(size * capacity);
+
+				char* memory = static_cast<char*>(_allocator->alloc(totalBytes, (uint8_t)COLUMN_ALIGNMENT));
+				size_t offset = 0;
+
+				std::apply([&](auto*&... column) {
+					((column = reinterpret_cast<std::remove_reference_t<decltype(column)>>(memory + offset),
+						offset += alignColumnSize(sizeof(*column) * capacity)), ...);
+				}, columns);
+
+				return memory;
+			}
+
+			/* Relocates every existing item into the new columns, then releases the old allocation. */
+			void replaceColumns(void* newMemory, Columns& newColumns, uint32_t newCapacity) {
+				relocateColumns(newColumns, Indices());
+
+				if (_memory != nullptr)
+					_allocator->dealloc(_memory);
+
+				_memory = newMemory;
+				_columns = newColumns;
+				_capacity = newCapacity;
+			}
+
+			template<size_t... I>
+			inline void relocateColumns(Columns& dest, std::index_sequence<I...>) {
+				(Relocation::relocate(std::get<I>(dest), std::get<I>(_columns), _count), ...);
+			}
+
+			template<size_t... I>
+			inline void relocateAroundGap(Columns& dest, uint32_t index, std::index_sequence<I...>) {
+				(Relocation::relocate(std::get<I>(dest), std::get<I>(_columns), index), ...);
+				(Relocation::relocate(std::get<I>(dest) + index + 1, std::get<I>(_columns) + index, _count - index), ...);
+			}
+
+			template<size_t... I>
+			inline void moveRow(std::tuple<Fields...>& row, uint32_t index, std::index_sequence<I...>) {
+				(new (&std::get<I>(_columns)[index]) FieldType<I>(std::move(std::get<I>(row))), ...);
+			}
+
+			template<size_t... I>
+			inline void copyColumns(const SoAList& other, std::index_sequence<I...>) {
+				(Relocation::copy(std::get<I>(_columns), std::get<I>(other._columns), other._count), ...);
+			}
+
+			template<size_t... I, typename... Args>
+			static inline void constructRow(Columns& columns, uint32_t index, std::index_sequence<I...>, Args&&... values) {
+				(new (&std::get<I>(columns)[index]) FieldType<I>(std::forward<Args>(values)), ...);
+			}
+
+			template<typename R, size_t... I>
+			inline R getRow(uint32_t index, std::index_sequence<I...>) const {
+				return R(std::get<I>(_columns)[index]...);
+			}
+
+			void takeFrom(SoAList& other) {
+				_columns = other._columns;
+				_memory = other._memory;
+				_count = other._count;
+				_capacity = other._capacity;
+				_allocator = other._allocator;
+
+				other._memory = nullptr;
+				other._count = 0;
+				other._capacity = 0;
+			}
+
+			void release() {
+				if (_memory == nullptr)
+					return;
+
+				clear();
+				_allocator->dealloc(_memory);
+				_memory = nullptr;
+				_capacity = 0;
+			}
+		};
+	}
+}
\ No newline at end of file
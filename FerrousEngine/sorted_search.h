@@ -0,0 +1,59 @@
+#pragma once
+#include "stdafx.h"
+#include <algorithm>
+
+namespace fe {
+	namespace collections {
+		/*	Binary searches over sorted arrays, used by FlatSet and FlatMap. Each step picks the next half with a conditional move instead of
+			a branch, so the CPU never mispredicts which half the key is in, and the loop length depends only on the number of keys. */
+		class SortedSearch {
+		public:
+			/* Returns the index of the first key which is not less than key, or count if there is none. */
+			template<typename K, typename Q, typename L>
+			static inline uint32_t lowerBound(const K* keys, uint32_t count, const Q& key, const L& less) {
+				if (count == 0)
+					return 0;
+
+				const K* base = keys;
+				while (count > 1) {
+					uint32_t half = count / 2;
+					base = less(base[half], key) ? base + half : base;
+					count -= half;
+				}
+
+				return (uint32_t)(base - keys) + (less(*base, key) ? 1 : 0);
+			}
+
+			/* Returns the index of the first key which is greater than key, or count if there is none. */
+			template<typename K, typename Q, typename L>
+			static inline uint32_t upperBound(const K* keys, uint32_t count, const Q& key, const L& less) {
+				if (count == 0)
+					return 0;
+
+				const K* base = keys;
+				while (count > 1) {
+					uint32_t half = count / 2;
+					base = less(key, base[half]) ? base : base + half;
+					count -= half;
+				}
+
+				return (uint32_t)(base - keys) + (less(key, *base) ? 0 : 1);
+			}
+
+			/*	Fills indices with 0 to count - 1, sorted by the key getKey(index) returns. Equal keys keep their original order, so the first
+				or last of each run of equal keys can be picked deterministically. Only indices are moved, never the keys themselves. */
+			template<typename GetKey, typename L>
+			static void sortIndices(uint32_t* indices, uint32_t count, GetKey getKey, const L& less) {
+				for (uint32_t i = 0; i < count; i++)
+					indices[i] = i;
+
+				std::sort(indices, indices + count, [&getKey, &less](uint32_t a, uint32_t b) {
+					if (less(getKey(a), getKey(b)))
+						return true;
+
+					return !less(getKey(b), getKey(a)) && a < b;
+				});
+			}
+		};
+	}
+}
\ No newline at end of file
@@ -0,0 +1,50 @@
+#pragma once
+#include "stdafx.h"
+#include "exceptions.h"
+#include "iterator_contiguous.h"
+
+namespace fe {
+	namespace collections {
+		/*	A non-owning view of count items stored contiguously in memory, such as a range of a List or one field of an SoAList.
+			Use Span<const T> for read-only access. The viewed items must outlive the span. */
+		template<typename T>
+		class Span {
+		public:
+			using iterator = ContiguousIterator<T>;
+
+			Span() : _data(nullptr), _count(0) { }
+
+			Span(T* data, uint32_t count) : _data(data), _count(count) { }
+
+			/* Allows a span to be converted to its read-only equivalent. */
+			template<typename U, typename = std::enable_if_t<std::is_same<const U, T>::value>>
+			Span(const Span<U>& other) : _data(other.data()), _count(other.count()) { }
+
+			inline iterator begin() const { return iterator(_data, 0); }
+			inline iterator end() const { return iterator(_data, _count); }
+
+			inline T* data() const { return _data; }
+			inline uint32_t count() const { return _count; }
+			inline bool isEmpty() const { return _count == 0; }
+
+			/* Returns a span of count items, starting at startIndex. */
+			inline Span slice(uint32_t startIndex, uint32_t count) const {
+				if (startIndex + count > _count)
+					throw IndexOutOfRangeExeption(startIndex + count, _count);
+
+				return Span(_data + startIndex, count);
+			}
+
+			inline T& operator[] (uint32_t index) const {
+				if (index >= _count)
+					throw IndexOutOfRangeExeption(index, _count);
+
+				return _data[index];
+			}
+
+		private:
+			T* _data;
+			uint32_t _count;
+		};
+	}
+}
\ No newline at end of file
@@ -4,4 +4,25 @@
 #include <stdint.h>
 #include <stdlib.h>
 #include <assert.h>
-#include <string>
\ No newline at end of file
+#include <string>
+
+/* SSE2 is guaranteed on x64. Used by vectorized fast-paths, which fall back to scalar code when unavailable. */
+#if defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define FE_SSE2
+#include <emmintrin.h>
+#endif
+
+/* Size of a CPU cache line. Members written by different threads are aligned to it, so they do not share (and contend for) a line. */
+#define FE_CACHE_LINE_SIZE 64
+
+/* Lets MSVC apply the empty base optimization to every empty base class, not just the first. */
+#ifdef _MSC_VER
+#define FE_EMPTY_BASES __declspec(empty_bases)
+#else
+#define FE_EMPTY_BASES
+#endif
+
+/* C++20 coroutines, used by fe::Task. The coroutine headers compile to nothing unless the compiler provides them (/std:c++20 or later). */
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#define FE_COROUTINES
+#endif
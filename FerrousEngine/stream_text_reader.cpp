@@ -2,7 +2,9 @@
 
 namespace fe {
 	TextStreamReader::TextStreamReader(Stream* stream, FerrousAllocator* allocator, size_t bufferSize) :
-		StreamReader(stream, allocator, bufferSize) {
+		StreamReader(stream, allocator, bufferSize), _decoder(stream->getEncoding()) {
+		_buffer_pos = 0;
+		_buffer_len = 0;
 	}
 
 	TextStreamReader::TextStreamReader(Stream* stream, size_t bufferSize) :
@@ -10,6 +12,20 @@ namespace fe {
 
 	TextStreamReader::~TextStreamReader() {}
 
+	bool TextStreamReader::fillBuffer() {
+		if (_buffer_pos < _buffer_len)
+			return true;
+
+		size_t bytesToRead = min(_stream->getReadBytesFromEnd(), _buffer_size);
+		if (bytesToRead == 0)
+			return false;
+
+		_stream->readBytes(_buffer, bytesToRead);
+		_buffer_pos = 0;
+		_buffer_len = bytesToRead;
+		return true;
+	}
+
 	void TextStreamReader::read(FeString* dest, uint32_t numChars) {
 		if (!_stream->isOpen())
 			throw StreamClosedError(_stream);
@@ -17,19 +33,22 @@ namespace fe {
 		if (!_stream->canRead())
 			throw StreamReadAccessError(_stream);
 
-		// Read (4 * count) bytes to cover worst-case scenario of 4 bytes per character.
-		// UTF-8, 16 and 32 all use a max of 4 bytes per character.
-		size_t bytesToRead = min(_stream->getReadBytesFromEnd(), (size_t)numChars * 4U);
-		char* c = _buffer;
+		char32_t* mem = _allocator->allocType<char32_t>(numChars + 1ULL);
+		uint32_t count = 0;
 
-		ensureBufferCapacity(bytesToRead);
-		_stream->readBytes(_buffer, bytesToRead);
+		// The decoder stops as soon as numChars have been decoded, so any bytes after them stay in the buffer for the next read.
+		while (count < numChars && fillBuffer()) {
+			size_t consumed = 0;
+			count += _decoder.decode(_buffer + _buffer_pos, _buffer_len - _buffer_pos, &mem[count], numChars - count, consumed);
+			_buffer_pos += consumed;
+		}
 
-		*dest = UtfString::decode(_buffer, numChars, _stream->getEncoding(), _allocator);
+		// End of stream. Replace any incomplete trailing sequence.
+		if (count < numChars)
+			count += _decoder.flush(&mem[count]);
 
-		// Move the stream backwards by the number of bytes that were left over after decoding.
-		int32_t numBytes = (int32_t)(c - (dest->len() * sizeof(wchar_t)));
-		_stream->seekRead(StreamSeek::Current, -numBytes);
+		mem[count] = U'\0';
+		*dest = FeString(mem, count, _allocator);
 	}
 
 	void TextStreamReader::readLine(FeString* dest) {
@@ -39,50 +58,48 @@ namespace fe {
 		if (!_stream->canRead())
 			throw StreamReadAccessError(_stream);
 
-		char* c = _buffer;
-		size_t numBytes = 0;
-
-		_stream->readBytes(c, 1);
+		if (!fillBuffer() && !_decoder.hasPending())
+			throw EndOfStreamError(_stream);
 
-		size_t end = _stream->getSize();
+		size_t capacity = 64;
+		size_t count = 0;
+		char32_t* mem = _allocator->allocType<char32_t>(capacity);
+		char32_t c = U'\0';
 
-		while (*c != '\n' && *c != EOF) {
-			size_t readPos = _stream->getReadPos();
-			if (readPos > end)
-				throw EndOfStreamError(_stream);
+		// Decode one character at a time, so nothing past the new-line is consumed.
+		while (fillBuffer()) {
+			size_t consumed = 0;
+			uint32_t decoded = _decoder.decode(_buffer + _buffer_pos, _buffer_len - _buffer_pos, &c, 1, consumed);
+			_buffer_pos += consumed;
 
-			c++;
-			numBytes++;
-			_stream->readBytes(c, 1);
-		}
+			if (decoded == 0)
+				continue;
 
-		*dest = UtfString::decode(_buffer, _stream->getEncoding(), numBytes, _allocator);
-	}
+			if (c == U'\n')
+				break;
 
-	void TextStreamReader::readLine(UtfString* dest) {
-		if (!_stream->isOpen())
-			throw StreamClosedError(_stream);
+			if (count + 1 == capacity) // Leave room for the null-terminator.
+				growBuffer(mem, capacity, count);
 
-		if (!_stream->canRead())
-			throw StreamReadAccessError(_stream);
+			mem[count++] = c;
+		}
 
-		char* c = _buffer;
-		size_t numBytes = 0;
-		_stream->readBytes(c, 1);
+		if (c != U'\n' && _decoder.flush(&c) > 0) {
+			if (count + 1 == capacity)
+				growBuffer(mem, capacity, count);
 
-		while (*c != '\n' && *c != EOF) {
-			c++;
-			numBytes++;
-			assert(numBytes < _buffer_size);
-			_stream->readBytes(c, 1);
+			mem[count++] = c;
 		}
 
-		if (*c == EOF)
-			throw EndOfStreamError(_stream);
+		mem[count] = U'\0';
+		*dest = FeString(mem, (uint32_t)count, _allocator);
+	}
 
-		char* mem = _allocator->allocType<char>(numBytes);
-		Memory::copy(mem, _buffer, numBytes);
-		new (dest) UtfString(mem, numBytes, _stream->getEncoding(), _allocator);
+	void TextStreamReader::readLine(UtfString* dest) {
+		// Decoded first, since a new-line byte may be part of a wider code unit, and the decoder may hold part of the line already.
+		FeString line;
+		readLine(&line);
+		new (dest) UtfString(line, _stream->getEncoding(), _allocator);
 	}
 
 	void TextStreamReader::readToEnd(FeString * dest) {
@@ -92,26 +109,26 @@ namespace fe {
 		if (!_stream->canRead())
 			throw StreamReadAccessError(_stream);
 
-		size_t curPos = _stream->getReadPos();
-		size_t bytesToRead = _stream->getSize() - curPos;
-		ensureBufferCapacity(bytesToRead);
+		// Every character takes at least one byte, plus one more in case an incomplete sequence is pending.
+		size_t maxChars = (_buffer_len - _buffer_pos) + _stream->getReadBytesFromEnd() + 1;
+		char32_t* mem = _allocator->allocType<char32_t>(maxChars + 1);
+		size_t count = 0;
 
-		_stream->readBytes(_buffer, bytesToRead);
-		*dest = UtfString::decode(_buffer, _stream->getEncoding(), bytesToRead, _allocator);
+		while (fillBuffer()) {
+			size_t consumed = 0;
+			count += _decoder.decode(_buffer + _buffer_pos, _buffer_len - _buffer_pos, &mem[count], (uint32_t)(maxChars - count), consumed);
+			_buffer_pos += consumed;
+		}
+
+		count += _decoder.flush(&mem[count]);
+		mem[count] = U'\0';
+		*dest = FeString(mem, (uint32_t)count, _allocator);
 	}
 
 	void TextStreamReader::readToEnd(UtfString * dest) {
-		if (!_stream->isOpen())
-			throw StreamClosedError(_stream);
-
-		if (!_stream->canRead())
-			throw StreamReadAccessError(_stream);
-
-		size_t curPos = _stream->getReadPos();
-		size_t bytesToRead = _stream->getSize() - curPos;
-		ensureBufferCapacity(bytesToRead);
-
-		_stream->readBytes(_buffer, bytesToRead);
-		new (dest) UtfString(_buffer, bytesToRead, _stream->getEncoding(), _allocator);
+		// Decoded first, so a sequence which an earlier read() left incomplete in the decoder is kept.
+		FeString text;
+		readToEnd(&text);
+		new (dest) UtfString(text, _stream->getEncoding(), _allocator);
 	}
-}
\ No newline at end of file
+}
@@ -1,5 +1,6 @@
 #pragma once
 #include "stream_reader.h"
+#include "strings_utf_decoder.h"
 
 namespace fe {
 	class TextStreamReader : StreamReader {
@@ -15,5 +16,23 @@ namespace fe {
 		void readLine(UtfString* dest);
 		void readToEnd(FeString* dest);
 		void readToEnd(UtfString* dest);
+
+	private:
+		UtfDecoder _decoder;
+		size_t _buffer_pos;		/* Position of the next unread byte in the buffer. */
+		size_t _buffer_len;		/* Number of valid bytes in the buffer. */
+
+		/* Refills the buffer from the stream once all of its bytes have been used. Returns false if the end of the stream was reached. */
+		bool fillBuffer();
+
+		/* Doubles the capacity of a temporary read buffer, keeping the first count elements. */
+		template<typename T>
+		void growBuffer(T*& mem, size_t& capacity, size_t count) {
+			capacity *= 2;
+			T* newMem = _allocator->allocType<T>(capacity);
+			Memory::copyType<T>(newMem, mem, count);
+			_allocator->dealloc(mem);
+			mem = newMem;
+		}
 	};
-}
\ No newline at end of file
+}
@@ -1,6 +1,9 @@
 #pragma once
 #include "stdafx.h"
 #include "allocation.h"
+#include "unicode.h"
+#include "hash.h"
+#include "relocation.h"
 #include <iostream>
 #include <cstdarg>
 
@@ -138,6 +141,22 @@ namespace fe {
 		/*Returns a pointer to the raw underlying character data.*/
 		const inline char32_t* getData() const { return _data; }
 
+		/*	Compares the string to another, by code point. Returns less than 0 if the current string comes first,
+			0 if both are equal, or more than 0 if the other string comes first. */
+		int32_t compare(const FeString& other) const;
+
+		/* Same as compare(), but ignores case using culture-invariant Unicode case folding. */
+		int32_t compareIgnoreCase(const FeString& other) const;
+
+		/* Returns true if both strings are equal when ignoring case. Uses culture-invariant Unicode case folding. */
+		bool equalsIgnoreCase(const FeString& other) const;
+
+		/* Returns a hash of the string's characters. Equal strings always produce the same hash. */
+		uint64_t hash() const;
+
+		/* Returns a hash of the string's case-folded characters. Strings which are equal when ignoring case always produce the same hash. */
+		uint64_t hashIgnoreCase() const;
+
 		/* Copy assignment operator*/
 		FeString& operator=(const FeString& other);
 
@@ -153,6 +172,14 @@ namespace fe {
 			return true;
 		}
 
+		inline bool operator!=(const FeString& other) const {
+			return !(*this == other);
+		}
+
+		inline bool operator<(const FeString& other) const {
+			return compare(other) < 0;
+		}
+
 	private:
 		friend FeString operator +(const FeString& a, const FeString& b);
 		friend FeString operator +(const FeString& a, const uint8_t& v);
@@ -177,6 +204,55 @@ namespace fe {
 		const bool _isHeap;			/* String was created from a literal and therefore should never dealloc its data. */
 	};
 
+	/*	A non-owning, read-only view of a range of characters, such as an FeString, part of one, or a null-terminated literal.
+		Never allocates, so it is cheap to pass to lookups. The viewed characters must outlive the view. */
+	class FeStringView {
+	public:
+		FeStringView(const char32_t* data, uint32_t len) : _data(data), _length(len) { }
+
+		/* Views a null-terminated string. */
+		FeStringView(const char32_t* data);
+
+		FeStringView(const FeString& str) : _data(str.getData()), _length(str.len()) { }
+
+		/* Returns a view of count characters, starting at startIndex. */
+		FeStringView slice(const uint32_t startIndex, const uint32_t count) const;
+
+		/* Gets the number of characters in the view. */
+		const inline uint32_t len() const { return _length; }
+
+		/* Returns a pointer to the first character. Unlike FeString, the data is not necessarily null-terminated. */
+		const inline char32_t* getData() const { return _data; }
+
+		/* Returns true if both views are equal when ignoring case. Uses culture-invariant Unicode case folding. */
+		bool equalsIgnoreCase(const FeStringView& other) const;
+
+		/* Compares the views character by character. Returns a negative number if this view sorts first, 0 if they are equal, or a positive number otherwise. */
+		int32_t compare(const FeStringView& other) const;
+
+		/* Returns a hash of the characters. Always the same as FeString::hash() for the same characters. */
+		uint64_t hash() const;
+
+		/* Returns a hash of the case-folded characters. Always the same as FeString::hashIgnoreCase() for the same characters. */
+		uint64_t hashIgnoreCase() const;
+
+		bool operator==(const FeStringView& other) const {
+			return _length == other._length && memcmp(_data, other._data, _length * sizeof(char32_t)) == 0;
+		}
+
+		inline bool operator!=(const FeStringView& other) const {
+			return !(*this == other);
+		}
+
+		inline bool operator<(const FeStringView& other) const {
+			return compare(other) < 0;
+		}
+
+	private:
+		const char32_t* _data;
+		uint32_t _length;
+	};
+
 	class UtfString {
 	public:
 		const static char UTF_BOM_8_NON[];
@@ -213,6 +289,9 @@ namespace fe {
 			return decode(_data, _length, _encoding, _allocator);
 		}
 
+		/* Calculates the exact number of bytes required to encode a string, excluding the null-terminator. Throws if the encoding is not supported. */
+		static size_t getEncodedSize(const FeString& string, UtfEncoding encoding);
+
 		inline const size_t byteLen() const { return _num_bytes; }
 		inline const size_t len() const { return _length; }
 		inline const char* getData() const { return _data; }
@@ -222,11 +301,15 @@ namespace fe {
 		const static uint8_t UTF8_LEAD_MASK[];
 		const static uint8_t UTF8_LEAD_CAPACITY[];
 		const static uint8_t UTF8_TRAIL_MASK;
+		const static char32_t UTF_MAX_CODEPOINT;
+		const static char32_t UTF_REPLACEMENT_CHAR;
 
-		void encode_utf8(const FeString& src, size_t max_bytes);
-		void encode_utf16_le(const FeString& src, size_t max_bytes);
-		void encode_utf16_be(const FeString& src, size_t max_bytes);
+		void encode_utf8(const FeString& src);
+		void encode_utf16_le(const FeString& src);
+		void encode_utf16_be(const FeString& src);
 		static uint32_t getNumChars(const char* data, size_t numBytes, UtfEncoding encoding);
+		static size_t getUtf8Size(const char32_t* src, uint32_t len);
+		static size_t getUtf16Size(const char32_t* src, uint32_t len);
 
 		char* _data;
 		char* _mem;
@@ -239,17 +322,18 @@ namespace fe {
 
 #pragma region OPERATORS
 	FeString operator +(const FeString& a, const FeString& b);
-	//FeString operator +(const FeString& a, const uint8_t& v);
-	//FeString operator +(const FeString& a, const uint16_t& v);
-	//FeString operator +(const FeString& a, const uint32_t& v);
-	//FeString operator +(const FeString& a, const uint64_t& v);
-	//FeString operator +(const FeString& a, const int8_t& v);
-	//FeString operator +(const FeString& a, const int16_t& v);
-	//FeString operator +(const FeString& a, const int32_t& v);
-	//FeString operator +(const FeString& a, const int64_t& v);
-	//FeString operator +(const FeString& a, const double& v);
-	//FeString operator +(const FeString& a, const long double& v);
-	//FeString operator +(const FeString& a, const float& v);
+	/* Number concatenation. Numbers are formatted with the current culture, without digit grouping. See: Number::toString() */
+	FeString operator +(const FeString& a, const uint8_t& v);
+	FeString operator +(const FeString& a, const uint16_t& v);
+	FeString operator +(const FeString& a, const uint32_t& v);
+	FeString operator +(const FeString& a, const uint64_t& v);
+	FeString operator +(const FeString& a, const int8_t& v);
+	FeString operator +(const FeString& a, const int16_t& v);
+	FeString operator +(const FeString& a, const int32_t& v);
+	FeString operator +(const FeString& a, const int64_t& v);
+	FeString operator +(const FeString& a, const double& v);
+	FeString operator +(const FeString& a, const long double& v);
+	FeString operator +(const FeString& a, const float& v);
 
 	FeString operator "" _fe(const char* a, size_t len);
 	FeString operator "" _fe(const wchar_t* a, size_t len);
@@ -257,4 +341,57 @@ namespace fe {
 
 
 #pragma endregion
+
+	namespace collections {
+		/*	Hashes FeString keys by their characters, instead of their data pointer.
+			Transparent, so FeString-keyed dictionaries can also be queried with an FeStringView or a null-terminated U"literal". */
+		template <>
+		struct DefaultKeyHash<FeString> {
+			using is_transparent = void;
+
+			uint64_t operator()(const FeStringView& key) const {
+				return key.hash();
+			}
+		};
+
+		template <>
+		struct DefaultKeyEquals<FeString> {
+			using is_transparent = void;
+
+			bool operator()(const FeString& a, const FeStringView& b) const {
+				return FeStringView(a) == b;
+			}
+		};
+
+		template <>
+		struct DefaultKeyLess<FeString> {
+			using is_transparent = void;
+
+			bool operator()(const FeStringView& a, const FeStringView& b) const {
+				return a < b;
+			}
+		};
+
+		/* FeString only points to its character data, never into itself, so it can be relocated with memcpy. */
+		template <>
+		struct IsTriviallyRelocatable<FeString> : std::true_type {};
+
+		/* Case-insensitive FeString key hash. Use with FeStringIgnoreCaseEquals. e.g. Dictionary<FeString, V, FeStringIgnoreCaseHash, FeStringIgnoreCaseEquals> */
+		struct FeStringIgnoreCaseHash {
+			using is_transparent = void;
+
+			uint64_t operator()(const FeStringView& key) const {
+				return key.hashIgnoreCase();
+			}
+		};
+
+		/* Case-insensitive FeString key comparer. Use with FeStringIgnoreCaseHash. */
+		struct FeStringIgnoreCaseEquals {
+			using is_transparent = void;
+
+			bool operator()(const FeString& a, const FeStringView& b) const {
+				return FeStringView(a).equalsIgnoreCase(b);
+			}
+		};
+	}
 }
\ No newline at end of file
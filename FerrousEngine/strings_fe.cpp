@@ -1,5 +1,7 @@
 #include "strings.h"
 #include "localization.h"
+#include "strings_number.h"
+#include "exceptions.h"
 #include <locale>
 #include <vector>
 
@@ -154,8 +156,7 @@ namespace fe {
 		char32_t* new_data = _allocator->allocType<char32_t>(_length + 1ULL);
 		Culture* cul = Localization::get()->getCurrentCulture();
 
-		for (uint32_t i = 0; i < _length; i++)
-			new_data[i] = cul->toLower(_data[i]);
+		cul->toLower(_data, new_data, _length);
 
 		new_data[_length] = U'\0';
 		return FeString(new_data, _length, _allocator);
@@ -168,8 +169,7 @@ namespace fe {
 		char32_t* new_data = _allocator->allocType<char32_t>(_length + 1ULL);
 		Culture* cul = Localization::get()->getCurrentCulture();
 
-		for (uint32_t i = 0; i < _length; i++)
-			new_data[i] = cul->toUpper(_data[i]);
+		cul->toUpper(_data, new_data, _length);
 
 		new_data[_length] = U'\0';
 		return FeString(new_data, _length, _allocator);
@@ -521,6 +521,38 @@ namespace fe {
 		return false;
 	}
 
+	int32_t FeString::compare(const FeString& other) const {
+		return FeStringView(*this).compare(other);
+	}
+
+	int32_t FeString::compareIgnoreCase(const FeString& other) const {
+		uint32_t len = min(_length, other._length);
+
+		for (uint32_t i = 0; i < len; i++) {
+			if (_data[i] == other._data[i])
+				continue;
+
+			char32_t a = Unicode::fold(_data[i]);
+			char32_t b = Unicode::fold(other._data[i]);
+			if (a != b)
+				return a < b ? -1 : 1;
+		}
+
+		return _length == other._length ? 0 : (_length < other._length ? -1 : 1);
+	}
+
+	bool FeString::equalsIgnoreCase(const FeString& other) const {
+		return FeStringView(*this).equalsIgnoreCase(other);
+	}
+
+	uint64_t FeString::hash() const {
+		return FeStringView(*this).hash();
+	}
+
+	uint64_t FeString::hashIgnoreCase() const {
+		return FeStringView(*this).hashIgnoreCase();
+	}
+
 	void FeString::toChar8(char* buffer) const {
 		for (uint32_t i = 0; i < _length; i++) 
 			buffer[i] = _data[i] < 128 ? _data[i] : '?';
@@ -566,17 +598,17 @@ namespace fe {
 		return FeString(mem, len, a._allocator);
 	}
 
-	//FeString operator +(const FeString& a, const uint8_t& v) { return FeString::format(L"%d", a._allocator, v); }
-	//FeString operator +(const FeString& a, const uint16_t& v) { return FeString::format(L"%d", a._allocator, v); }
-	//FeString operator +(const FeString& a, const uint32_t& v) { return FeString::format(L"%d", a._allocator, v); }
-	//FeString operator +(const FeString& a, const uint64_t& v) { return FeString::format(L"%d", a._allocator, v); }
-	//FeString operator +(const FeString& a, const int8_t& v) { return FeString::format(L"%d", a._allocator, v); }
-	//FeString operator +(const FeString& a, const int16_t& v) { return FeString::format(L"%d", a._allocator, v); }
-	//FeString operator +(const FeString& a, const int32_t& v) { return FeString::format(L"%d", a._allocator, v); }
-	//FeString operator +(const FeString& a, const int64_t& v) { return FeString::format(L"%d", a._allocator, v); }
-	//FeString operator +(const FeString& a, const double& v) { return FeString::format(L"%f", a._allocator, v); }
-	//FeString operator +(const FeString& a, const long double& v) { return FeString::format(L"%f", a._allocator, v); }
-	FeString operator +(const FeString & a, const float& v) { return FeString::format(U"%f", a._allocator, v); }
+	FeString operator +(const FeString& a, const uint8_t& v) { return a + Number::toString((uint64_t)v, false, nullptr, a._allocator); }
+	FeString operator +(const FeString& a, const uint16_t& v) { return a + Number::toString((uint64_t)v, false, nullptr, a._allocator); }
+	FeString operator +(const FeString& a, const uint32_t& v) { return a + Number::toString((uint64_t)v, false, nullptr, a._allocator); }
+	FeString operator +(const FeString& a, const uint64_t& v) { return a + Number::toString(v, false, nullptr, a._allocator); }
+	FeString operator +(const FeString& a, const int8_t& v) { return a + Number::toString((int64_t)v, false, nullptr, a._allocator); }
+	FeString operator +(const FeString& a, const int16_t& v) { return a + Number::toString((int64_t)v, false, nullptr, a._allocator); }
+	FeString operator +(const FeString& a, const int32_t& v) { return a + Number::toString((int64_t)v, false, nullptr, a._allocator); }
+	FeString operator +(const FeString& a, const int64_t& v) { return a + Number::toString(v, false, nullptr, a._allocator); }
+	FeString operator +(const FeString& a, const double& v) { return a + Number::toString(v, false, nullptr, a._allocator); }
+	FeString operator +(const FeString& a, const long double& v) { return a + Number::toString((double)v, false, nullptr, a._allocator); }
+	FeString operator +(const FeString& a, const float& v) { return a + Number::toString(v, false, nullptr, a._allocator); }
 
 	FeString operator "" _fe(const char* a, size_t len) {
 		return FeString(a, len, Memory::get());
@@ -590,4 +622,63 @@ namespace fe {
 		return FeString(a, len, Memory::get(), false);
 	}
 #pragma endregion
+
+	FeStringView::FeStringView(const char32_t* data) : _data(data) {
+		_length = 0;
+		while (data[_length] != U'\0')
+			_length++;
+	}
+
+	FeStringView FeStringView::slice(const uint32_t startIndex, const uint32_t count) const {
+		if (startIndex + count > _length)
+			throw IndexOutOfRangeExeption(startIndex + count, _length);
+
+		return FeStringView(_data + startIndex, count);
+	}
+
+	bool FeStringView::equalsIgnoreCase(const FeStringView& other) const {
+		if (_length != other._length)
+			return false;
+
+		for (uint32_t i = 0; i < _length; i++) {
+			// Only fold characters which differ. Most compared characters will already be identical.
+			if (_data[i] != other._data[i] && Unicode::fold(_data[i]) != Unicode::fold(other._data[i]))
+				return false;
+		}
+
+		return true;
+	}
+
+	int32_t FeStringView::compare(const FeStringView& other) const {
+		uint32_t len = min(_length, other._length);
+
+		for (uint32_t i = 0; i < len; i++) {
+			if (_data[i] != other._data[i])
+				return _data[i] < other._data[i] ? -1 : 1;
+		}
+
+		return _length == other._length ? 0 : (_length < other._length ? -1 : 1);
+	}
+
+	uint64_t FeStringView::hash() const {
+		return collections::Hash::bytes(_data, _length * sizeof(char32_t));
+	}
+
+	uint64_t FeStringView::hashIgnoreCase() const {
+		// Fold the string in chunks, chaining each chunk's hash into the next as its seed.
+		char32_t folded[32];
+		uint64_t h = 0;
+		uint32_t i = 0;
+
+		do {
+			uint32_t count = min(_length - i, 32U);
+			for (uint32_t j = 0; j < count; j++)
+				folded[j] = Unicode::fold(_data[i + j]);
+
+			h = collections::Hash::bytes(folded, count * sizeof(char32_t), h);
+			i += count;
+		} while (i < _length);
+
+		return h;
+	}
 }
\ No newline at end of file
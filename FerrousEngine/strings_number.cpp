@@ -0,0 +1,194 @@
+#include "strings_number.h"
+#include "localization.h"
+#include <charconv>
+
+namespace fe {
+	const NumberFormatInfo& Number::getFormat(const Culture* culture) {
+		if (culture == nullptr)
+			culture = Localization::get()->getCurrentCulture();
+
+		return culture->numberInfo();
+	}
+
+	size_t Number::toAscii(const FeString& str, char* dest, const NumberFormatInfo& info, bool isFloat) {
+		const char32_t* src = str.getData();
+		uint32_t start = 0;
+		uint32_t end = str.len();
+
+		while (start < end && Unicode::isWhitespace(src[start]))
+			start++;
+
+		while (end > start && Unicode::isWhitespace(src[end - 1]))
+			end--;
+
+		if (start == end || (end - start) >= NUMBER_BUFFER_SIZE)
+			return 0;
+
+		// std::from_chars does not accept a leading '+'.
+		if (src[start] == info.PositiveSign) {
+			start++;
+			if (start == end || src[start] == info.NegativeSign)
+				return 0;
+		}
+
+		size_t len = 0;
+
+		// Fast path: cultures which use '.' and '-' can narrow ASCII characters straight into the buffer,
+		// as long as there are no group separators to remove. Anything else is validated by std::from_chars.
+		if (info.DecimalPoint == U'.' && info.NegativeSign == U'-') {
+			for (uint32_t i = start; i < end; i++) {
+				char32_t c = src[i];
+				if (c >= 128 || c == info.NumberSeparator)
+					break;
+
+				dest[len++] = (char)c;
+			}
+
+			if (len == (end - start))
+				return len;
+
+			len = 0;
+		}
+
+		bool integral = true;	/* Group separators are only accepted between integral digits. */
+		bool grouped = false;	/* Whether a group separator has been seen. */
+		uint32_t groupDigits = 0;	/* Integral digits since the start of the number, or the last group separator. */
+
+		for (uint32_t i = start; i < end; i++) {
+			char32_t c = src[i];
+
+			if (c >= U'0' && c <= U'9') {
+				dest[len++] = (char)c;
+				if (integral)
+					groupDigits++;
+			}
+			else if (i == start && c == info.NegativeSign) {
+				dest[len++] = '-';
+			}
+			else if (integral && c == info.NumberSeparator) {
+				// The first group may be short, e.g. 1,234, but every later group must be exactly GroupSize digits.
+				if (groupDigits == 0 || groupDigits > info.GroupSize || (grouped && groupDigits != info.GroupSize))
+					return 0;
+
+				grouped = true;
+				groupDigits = 0;
+			}
+			else if (isFloat && integral && (c == info.DecimalPoint || c < 128)) { // Decimal point, exponent, inf or nan.
+				if (grouped && groupDigits != info.GroupSize)
+					return 0;
+
+				dest[len++] = c == info.DecimalPoint ? '.' : (char)c;
+				integral = false;
+			}
+			else if (isFloat && c < 128) {
+				dest[len++] = (char)c;
+			}
+			else {
+				return 0;
+			}
+		}
+
+		if (integral && grouped && groupDigits != info.GroupSize)
+			return 0;
+
+		return len;
+	}
+
+	template<typename T>
+	bool Number::parseNumber(const FeString& str, T& result, const Culture* culture) {
+		char buffer[NUMBER_BUFFER_SIZE];
+		size_t len = toAscii(str, buffer, getFormat(culture), std::is_floating_point<T>::value);
+		if (len == 0)
+			return false;
+
+		T value = 0;
+		std::from_chars_result r = std::from_chars(buffer, buffer + len, value);
+		if (r.ec != std::errc() || r.ptr != buffer + len)
+			return false;
+
+		result = value;
+		return true;
+	}
+
+	bool Number::tryParse(const FeString& str, int32_t& result, const Culture* culture) {
+		return parseNumber(str, result, culture);
+	}
+
+	bool Number::tryParse(const FeString& str, int64_t& result, const Culture* culture) {
+		return parseNumber(str, result, culture);
+	}
+
+	bool Number::tryParse(const FeString& str, uint32_t& result, const Culture* culture) {
+		return parseNumber(str, result, culture);
+	}
+
+	bool Number::tryParse(const FeString& str, uint64_t& result, const Culture* culture) {
+		return parseNumber(str, result, culture);
+	}
+
+	bool Number::tryParse(const FeString& str, float& result, const Culture* culture) {
+		return parseNumber(str, result, culture);
+	}
+
+	bool Number::tryParse(const FeString& str, double& result, const Culture* culture) {
+		return parseNumber(str, result, culture);
+	}
+
+	FeString Number::fromAscii(const char* src, size_t len, bool group, const NumberFormatInfo& info, FerrousAllocator* allocator) {
+		size_t intStart = (len > 0 && src[0] == '-') ? 1 : 0;
+		size_t intEnd = intStart;
+		while (intEnd < len && src[intEnd] >= '0' && src[intEnd] <= '9')
+			intEnd++;
+
+		size_t intDigits = intEnd - intStart;
+		size_t separators = (group && info.GroupSize > 0 && intDigits > 0) ? (intDigits - 1) / info.GroupSize : 0;
+		size_t newLen = len + separators;
+
+		char32_t* mem = allocator->allocType<char32_t>(newLen + 1);
+		char32_t* dest = mem;
+
+		for (size_t i = 0; i < len; i++) {
+			switch (src[i]) {
+			case '-': *dest = info.NegativeSign; break;
+			case '+': *dest = info.PositiveSign; break;
+			case '.': *dest = info.DecimalPoint; break;
+			default: *dest = src[i]; break;
+			}
+
+			dest++;
+
+			// Insert a separator after every digit which leaves a whole number of groups before the end of the integral part.
+			if (separators > 0 && i >= intStart && (i + 1) < intEnd && ((intEnd - i - 1) % info.GroupSize) == 0) {
+				*dest = info.NumberSeparator;
+				dest++;
+			}
+		}
+
+		mem[newLen] = U'\0';
+		return FeString(mem, (uint32_t)newLen, allocator);
+	}
+
+	FeString Number::toString(int64_t value, bool group, const Culture* culture, FerrousAllocator* allocator) {
+		char buffer[NUMBER_BUFFER_SIZE];
+		std::to_chars_result r = std::to_chars(buffer, buffer + NUMBER_BUFFER_SIZE, value);
+		return fromAscii(buffer, r.ptr - buffer, group, getFormat(culture), allocator);
+	}
+
+	FeString Number::toString(uint64_t value, bool group, const Culture* culture, FerrousAllocator* allocator) {
+		char buffer[NUMBER_BUFFER_SIZE];
+		std::to_chars_result r = std::to_chars(buffer, buffer + NUMBER_BUFFER_SIZE, value);
+		return fromAscii(buffer, r.ptr - buffer, group, getFormat(culture), allocator);
+	}
+
+	FeString Number::toString(double value, bool group, const Culture* culture, FerrousAllocator* allocator) {
+		char buffer[NUMBER_BUFFER_SIZE];
+		std::to_chars_result r = std::to_chars(buffer, buffer + NUMBER_BUFFER_SIZE, value); // Shortest round-trip representation.
+		return fromAscii(buffer, r.ptr - buffer, group, getFormat(culture), allocator);
+	}
+
+	FeString Number::toString(float value, bool group, const Culture* culture, FerrousAllocator* allocator) {
+		char buffer[NUMBER_BUFFER_SIZE];
+		std::to_chars_result r = std::to_chars(buffer, buffer + NUMBER_BUFFER_SIZE, value);
+		return fromAscii(buffer, r.ptr - buffer, group, getFormat(culture), allocator);
+	}
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include "strings.h"
+#include "culture.h"
+#include "exceptions.h"
+
+namespace fe {
+	/*	Culture-aware conversion between numbers and FeString.
+		Uses the NumberFormatInfo of the provided culture, or the current culture if none is provided.
+		Floating-point values are printed in their shortest form that parses back to exactly the same value. */
+	class Number {
+	public:
+		/*	Attempts to parse an integer. Leading and trailing whitespace is ignored. The integral digits may be grouped with the culture's number
+			separator, but only into groups of the culture's group size after the first, e.g. 1,234,567 but not 1,2,3 or 12,34.
+			Returns false if the string is not a valid number, or does not fit in the result type. */
+		static bool tryParse(const FeString& str, int32_t& result, const Culture* culture = nullptr);
+		static bool tryParse(const FeString& str, int64_t& result, const Culture* culture = nullptr);
+		static bool tryParse(const FeString& str, uint32_t& result, const Culture* culture = nullptr);
+		static bool tryParse(const FeString& str, uint64_t& result, const Culture* culture = nullptr);
+
+		/*	Attempts to parse a floating-point number. Accepts the culture's decimal point, an optional exponent (e.g. 1.5e-3), "inf" and "nan". */
+		static bool tryParse(const FeString& str, float& result, const Culture* culture = nullptr);
+		static bool tryParse(const FeString& str, double& result, const Culture* culture = nullptr);
+
+		/* Parses a number. Throws a NumberFormatException if the string is not a valid number of type T. */
+		template<typename T>
+		static T parse(const FeString& str, const Culture* culture = nullptr) {
+			T result = 0;
+			if (!tryParse(str, result, culture))
+				throw NumberFormatException();
+
+			return result;
+		}
+
+		/* Converts a number to a string. If group is true, the integral digits are grouped with the culture's number separator. e.g. 1,234,567 */
+		static FeString toString(int64_t value, bool group = false, const Culture* culture = nullptr, FerrousAllocator* allocator = Memory::get());
+		static FeString toString(uint64_t value, bool group = false, const Culture* culture = nullptr, FerrousAllocator* allocator = Memory::get());
+		static FeString toString(double value, bool group = false, const Culture* culture = nullptr, FerrousAllocator* allocator = Memory::get());
+		static FeString toString(float value, bool group = false, const Culture* culture = nullptr, FerrousAllocator* allocator = Memory::get());
+
+	private:
+		/* Enough for any integer or shortest round-trip double, including sign, decimal point and exponent. */
+		static constexpr size_t NUMBER_BUFFER_SIZE = 64;
+
+		template<typename T>
+		static bool parseNumber(const FeString& str, T& result, const Culture* culture);
+
+		/* Maps a culture-formatted number to ASCII, ready for std::from_chars. Returns the number of chars written, or 0 if the string is invalid or too long. */
+		static size_t toAscii(const FeString& str, char* dest, const NumberFormatInfo& info, bool isFloat);
+
+		/* Converts ASCII produced by std::to_chars into a culture-formatted FeString. */
+		static FeString fromAscii(const char* src, size_t len, bool group, const NumberFormatInfo& info, FerrousAllocator* allocator);
+
+		static const NumberFormatInfo& getFormat(const Culture* culture);
+	};
+}
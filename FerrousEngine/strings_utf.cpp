@@ -10,6 +10,8 @@ namespace fe {
 	const char* UtfString::UTF_BOM[] = { UtfString::UTF_BOM_8_NON, UtfString::UTF_BOM_8_NON, UtfString::UTF_BOM_8, UtfString::UTF_BOM_16_BE, UtfString::UTF_BOM_16_LE };
 
 	const uint8_t UtfString::UTF8_TRAIL_MASK = 0b10000000;
+	const char32_t UtfString::UTF_MAX_CODEPOINT = 0x10FFFF;
+	const char32_t UtfString::UTF_REPLACEMENT_CHAR = 0xFFFD;
 	const uint8_t UtfString::UTF8_LEAD_MASK[] = {
 		0b0, // Dummy for 0-bytes         - 0xxxxxxx
 		0b0, // Dummy for 1-byte          - 0xxxxxxx
@@ -38,21 +40,23 @@ namespace fe {
 	UtfString::UtfString(const FeString& string, UtfEncoding encoding, FerrousAllocator* allocator, bool isHeap) : _isHeap(isHeap) {
 		_length = string.len();
 		_allocator = allocator;
-		_num_bytes = 0;
 		_encoding = encoding;
-		size_t required_bytes = (sizeof(char32_t) * _length);
-		_mem = _allocator->allocType<char>(required_bytes); // Alloc for worst case scenario of 4-bytes per char.
+		_num_bytes = getEncodedSize(string, encoding);
+
+		// Allocate the exact encoded size, plus room for a null-terminator of the encoding's code unit size.
+		size_t terminator_bytes = (encoding == UtfEncoding::UTF16_LE || encoding == UtfEncoding::UTF16_BE) ? sizeof(char16_t) : sizeof(char);
+		_mem = _allocator->allocType<char>(_num_bytes + terminator_bytes);
 		_data = _mem;
 
 		switch (encoding) {
 		case UtfEncoding::Auto:
 		case UtfEncoding::UTF8: // https://en.wikipedia.org/wiki/UTF-8
 		case UtfEncoding::UTF8_WithBOM:
-			encode_utf8(string, required_bytes);
+			encode_utf8(string);
 			break;
 
-		case UtfEncoding::UTF16_LE: encode_utf16_le(string, required_bytes); break;
-		case UtfEncoding::UTF16_BE: encode_utf16_be(string, required_bytes); break;
+		case UtfEncoding::UTF16_LE: encode_utf16_le(string); break;
+		case UtfEncoding::UTF16_BE: encode_utf16_be(string); break;
 
 		default:
 			// TODO throw exception for invalid encoding
@@ -124,70 +128,137 @@ namespace fe {
 		return *this;
 	}
 
-	void UtfString::encode_utf8(const FeString& string, size_t max_bytes) {
-		_data += max_bytes - 1;
+	size_t UtfString::getEncodedSize(const FeString& string, UtfEncoding encoding) {
+		switch (encoding) {
+		case UtfEncoding::Auto:
+		case UtfEncoding::UTF8:
+		case UtfEncoding::UTF8_WithBOM:
+			return getUtf8Size(string.getData(), string.len());
+
+		case UtfEncoding::UTF16_LE:
+		case UtfEncoding::UTF16_BE:
+			return getUtf16Size(string.getData(), string.len());
+
+		default:
+			throw "Unsupported text encoding.";
+		}
+	}
+
+	size_t UtfString::getUtf8Size(const char32_t* src, uint32_t len) {
+		size_t num_bytes = len; // Every character needs at least 1 byte.
+		uint32_t i = 0;
+
+#ifdef FE_SSE2
+		// SSE2 only has signed 32-bit compares, so flip the sign bit of both sides to compare unsigned values.
+		const int32_t sign = INT32_MIN;
+		const __m128i bias = _mm_set1_epi32(sign);
+		const __m128i over_1 = _mm_set1_epi32(0x7F ^ sign);
+		const __m128i over_2 = _mm_set1_epi32(0x7FF ^ sign);
+		const __m128i over_3 = _mm_set1_epi32(0xFFFF ^ sign);
+		const __m128i over_max = _mm_set1_epi32((int32_t)UTF_MAX_CODEPOINT ^ sign);
+
+		// Each compare yields -1 per lane, for every extra byte a character needs.
+		// Invalid code points are encoded as the 3-byte replacement character, so take one byte back off them.
+		// Flush the lane counters regularly so they cannot overflow on very long strings.
+		while (len - i >= 4) {
+			__m128i extra = _mm_setzero_si128();
+			uint32_t block_end = i + min(len - i, 1U << 20) / 4 * 4;
+
+			for (; i < block_end; i += 4) {
+				__m128i c = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)), bias);
+				extra = _mm_add_epi32(extra, _mm_cmpgt_epi32(c, over_1));
+				extra = _mm_add_epi32(extra, _mm_cmpgt_epi32(c, over_2));
+				extra = _mm_add_epi32(extra, _mm_cmpgt_epi32(c, over_3));
+				extra = _mm_sub_epi32(extra, _mm_cmpgt_epi32(c, over_max));
+			}
+
+			int32_t lanes[4];
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), extra);
+			num_bytes += (size_t)-((int64_t)lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+		}
+#endif
+
+		for (; i < len; i++) {
+			char32_t c = src[i];
+			num_bytes += (c > 0x7F) + (c > 0x7FF) + (c > 0xFFFF) - (c > UTF_MAX_CODEPOINT);
+		}
+
+		return num_bytes;
+	}
+
+	size_t UtfString::getUtf16Size(const char32_t* src, uint32_t len) {
+		size_t num_units = len;
 
-		char* r_end = _data;
+		// Only supplementary-plane characters need a second (surrogate) code unit.
+		for (uint32_t i = 0; i < len; i++)
+			num_units += (src[i] > 0xFFFF) & (src[i] <= UTF_MAX_CODEPOINT);
+
+		return num_units * sizeof(char16_t);
+	}
+
+	void UtfString::encode_utf8(const FeString& string) {
+		uint8_t* dest = reinterpret_cast<uint8_t*>(_data);
 		const char32_t* src = string.getData();
-		uint32_t pos = string.len() + 1; // Start with the null terminator
 
-		while (pos > 0) {
-			pos--;
+		for (uint32_t pos = 0; pos < _length; pos++) {
+			char32_t c = src[pos];
 
-			if (src[pos] < 128) {
-				*_data = (char)src[pos];
+			if (c < 128) {
+				*dest = (uint8_t)c;
+				dest++;
 			}
 			else {
-				uint8_t char_bytes = 1;
-				char32_t c = src[pos];
-				while (c > UTF8_LEAD_CAPACITY[char_bytes]) {
-					*_data = UTF8_TRAIL_MASK | (c & 63); // first 6 bits = c & (32 | 16 | 8 | 4 | 2 | 1)
+				if (c > UTF_MAX_CODEPOINT)
+					c = UTF_REPLACEMENT_CHAR;
+
+				uint8_t char_bytes = c > 0xFFFF ? 4 : (c > 0x7FF ? 3 : 2);
+
+				// Fill the trailing bytes from the end of the character, then the lead byte.
+				for (uint8_t b = char_bytes - 1; b > 0; b--) {
+					dest[b] = UTF8_TRAIL_MASK | (c & 63); // first 6 bits = c & (32 | 16 | 8 | 4 | 2 | 1)
 					c = c >> 6;
-					char_bytes++;
-					_data--;
 				}
 
-				*_data = (UTF8_LEAD_MASK[char_bytes]) | c;
+				dest[0] = UTF8_LEAD_MASK[char_bytes] | c;
+				dest += char_bytes;
 			}
-
-			_data--;
 		}
 
-		_data++;
-		_num_bytes = r_end - _data;
+		*dest = '\0';
+		assert((size_t)(reinterpret_cast<char*>(dest) - _data) == _num_bytes);
 	}
 
-	void UtfString::encode_utf16_le(const FeString& string, size_t max_bytes) {
+	void UtfString::encode_utf16_le(const FeString& string) {
 		char16_t* utfData = reinterpret_cast<char16_t*>(_data);
 
 		const char32_t* src = string.getData();
 		uint32_t pos = 0;
 
-		// TODO separate each encoding into its own function. UTF-16 does not need to work backwards.
 		while (pos < _length) {
 			char32_t c = src[pos];
-			if ((c >= 0x0000 && c <= 0xD7FF) ||		// Reserved codepoint?
-				(c >= 0xE000 && c <= 0xFFFF)) {		// Surrogate pair?
+			if ((c >= 0x0000 && c <= 0xD7FF) ||		// Basic multilingual plane, below the surrogate range?
+				(c >= 0xE000 && c <= 0xFFFF)) {		// Basic multilingual plane, above the surrogate range?
 				*utfData = c;
 			}
-			else if (c >= 0xD800 && c <= 0xDFFF) {		// Reserved codepoint
-				*utfData = 0xFFFD; // Unicode replacement character
+			else if ((c >= 0xD800 && c <= 0xDFFF) || c > UTF_MAX_CODEPOINT) {		// Reserved surrogate codepoint, or out of range.
+				*utfData = UTF_REPLACEMENT_CHAR;
 			}
 			else {	// Surrogate pair
 				c -= 0x10000;
-				*utfData = ((c >> 10) / 0x400) + 0xD800; // high byte
+				*utfData = (c >> 10) + 0xD800; // high surrogate
 				utfData++;
-				*utfData = (c & 1023) + 0xDC00; // low byte
+				*utfData = (c & 1023) + 0xDC00; // low surrogate
 			}
 
 			pos++;
 			utfData++;
 		}
 
-		_num_bytes = (utfData - reinterpret_cast<char16_t*>(_data)) * sizeof(char16_t);
+		*utfData = u'\0';
+		assert((utfData - reinterpret_cast<char16_t*>(_data)) * sizeof(char16_t) == _num_bytes);
 	}
 
-	void UtfString::encode_utf16_be(const FeString & string, size_t max_bytes) {
+	void UtfString::encode_utf16_be(const FeString & string) {
 		throw "Not implemented";
 	}
 	FeString UtfString::decode(const char* data, UtfEncoding dataEncoding, size_t numBytes, FerrousAllocator * allocator) {
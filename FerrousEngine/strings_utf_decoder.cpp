@@ -0,0 +1,175 @@
+#include "strings_utf_decoder.h"
+
+namespace fe {
+	const char32_t UtfDecoder::REPLACEMENT_CHAR = 0xFFFD;
+
+	UtfDecoder::UtfDecoder(UtfEncoding encoding) {
+		_encoding = encoding;
+		reset();
+	}
+
+	void UtfDecoder::reset() {
+		_pending = 0;
+		_pending_min = 0;
+		_pending_needed = 0;
+		_pending_byte = 0;
+		_has_pending_byte = false;
+		_high_surrogate = 0;
+	}
+
+	bool UtfDecoder::hasPending() const {
+		return _pending_needed > 0 || _has_pending_byte || _high_surrogate != 0;
+	}
+
+	uint32_t UtfDecoder::flush(char32_t* dest) {
+		if (!hasPending())
+			return 0;
+
+		reset();
+		*dest = REPLACEMENT_CHAR;
+		return 1;
+	}
+
+	uint32_t UtfDecoder::decode(const char* src, size_t numBytes, char32_t* dest, uint32_t maxChars, size_t& bytesConsumed) {
+		const uint8_t* bytes = reinterpret_cast<const uint8_t*>(src);
+
+		switch (_encoding) {
+		case UtfEncoding::Auto:
+		case UtfEncoding::UTF8: // https://en.wikipedia.org/wiki/UTF-8
+		case UtfEncoding::UTF8_WithBOM:
+			return decodeUtf8(bytes, numBytes, dest, maxChars, bytesConsumed);
+
+		case UtfEncoding::UTF16_LE: return decodeUtf16(bytes, numBytes, dest, maxChars, bytesConsumed, false);
+		case UtfEncoding::UTF16_BE: return decodeUtf16(bytes, numBytes, dest, maxChars, bytesConsumed, true);
+
+		default:
+			throw "Unsupported text encoding.";
+		}
+	}
+
+	uint32_t UtfDecoder::decodeUtf8(const uint8_t* src, size_t numBytes, char32_t* dest, uint32_t maxChars, size_t& bytesConsumed) {
+		size_t i = 0;
+		uint32_t count = 0;
+
+		while (i < numBytes && count < maxChars) {
+			uint8_t b = src[i];
+
+			if (_pending_needed == 0) {
+#ifdef FE_SSE2
+				// Widen runs of 16 ASCII bytes straight into the destination.
+				while (numBytes - i >= 16 && maxChars - count >= 16) {
+					__m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+					if (_mm_movemask_epi8(chunk) != 0)
+						break;
+
+					const __m128i zero = _mm_setzero_si128();
+					__m128i lo = _mm_unpacklo_epi8(chunk, zero);
+					__m128i hi = _mm_unpackhi_epi8(chunk, zero);
+					__m128i* out = reinterpret_cast<__m128i*>(dest + count);
+					_mm_storeu_si128(out, _mm_unpacklo_epi16(lo, zero));
+					_mm_storeu_si128(out + 1, _mm_unpackhi_epi16(lo, zero));
+					_mm_storeu_si128(out + 2, _mm_unpacklo_epi16(hi, zero));
+					_mm_storeu_si128(out + 3, _mm_unpackhi_epi16(hi, zero));
+					i += 16;
+					count += 16;
+				}
+
+				if (i == numBytes || count == maxChars)
+					break;
+
+				b = src[i];
+#endif
+				if (b < 0x80) { // ASCII
+					dest[count++] = b;
+				}
+				else if (b >= 0xC2 && b <= 0xDF) { // 2-byte lead - 110xxxxx
+					_pending = b & 0x1F;
+					_pending_needed = 1;
+					_pending_min = 0x80;
+				}
+				else if (b >= 0xE0 && b <= 0xEF) { // 3-byte lead - 1110xxxx
+					_pending = b & 0x0F;
+					_pending_needed = 2;
+					_pending_min = 0x800;
+				}
+				else if (b >= 0xF0 && b <= 0xF4) { // 4-byte lead - 11110xxx
+					_pending = b & 0x07;
+					_pending_needed = 3;
+					_pending_min = 0x10000;
+				}
+				else { // Stray continuation byte, or a lead byte which can only produce invalid code points.
+					dest[count++] = REPLACEMENT_CHAR;
+				}
+
+				i++;
+			}
+			else {
+				// All bytes after the first byte should have a bit pattern of 10xxxxxx.
+				// If not, the sequence was truncated. Replace it and decode the current byte again as a new lead byte.
+				if ((b & 0xC0) != 0x80) {
+					_pending_needed = 0;
+					dest[count++] = REPLACEMENT_CHAR;
+					continue;
+				}
+
+				_pending = (_pending << 6) | (b & 0x3F);
+				_pending_needed--;
+				i++;
+
+				if (_pending_needed == 0) {
+					char32_t c = _pending;
+					if (c < _pending_min || c > 0x10FFFF || (c >= 0xD800 && c <= 0xDFFF)) // Overlong, out of range or surrogate.
+						c = REPLACEMENT_CHAR;
+
+					dest[count++] = c;
+				}
+			}
+		}
+
+		bytesConsumed = i;
+		return count;
+	}
+
+	uint32_t UtfDecoder::decodeUtf16(const uint8_t* src, size_t numBytes, char32_t* dest, uint32_t maxChars, size_t& bytesConsumed, bool bigEndian) {
+		size_t i = 0;
+		uint32_t count = 0;
+
+		while (i < numBytes && count < maxChars) {
+			if (!_has_pending_byte) {
+				_pending_byte = src[i++];
+				_has_pending_byte = true;
+				continue;
+			}
+
+			char16_t unit = bigEndian ? (char16_t)((_pending_byte << 8) | src[i]) : (char16_t)(_pending_byte | (src[i] << 8));
+
+			if (_high_surrogate != 0) {
+				if (unit >= 0xDC00 && unit <= 0xDFFF) {
+					dest[count++] = 0x10000 + ((char32_t)(_high_surrogate - 0xD800) << 10) + (unit - 0xDC00);
+					_has_pending_byte = false;
+					i++;
+				}
+				else {
+					// Unpaired high surrogate. The current unit is left unconsumed so it is decoded by the next iteration.
+					dest[count++] = REPLACEMENT_CHAR;
+				}
+
+				_high_surrogate = 0;
+				continue;
+			}
+
+			_has_pending_byte = false;
+			i++;
+
+			if (unit >= 0xD800 && unit <= 0xDBFF)
+				_high_surrogate = unit;
+			else if (unit >= 0xDC00 && unit <= 0xDFFF) // Unpaired low surrogate.
+				dest[count++] = REPLACEMENT_CHAR;
+			else
+				dest[count++] = unit;
+		}
+
+		bytesConsumed = i;
+		return count;
+	}
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include "strings.h"
+
+namespace fe {
+	/*	An incremental UTF decoder which can be fed input in arbitrarily-sized chunks.
+		Multi-byte sequences which straddle the end of a chunk are carried over to the next call to decode(). */
+	class UtfDecoder {
+	public:
+		UtfDecoder(UtfEncoding encoding = UtfEncoding::UTF8);
+
+		/*	Decodes up to maxChars characters from src into dest and returns the number of characters written.
+			bytesConsumed receives the number of bytes taken from src. This includes the bytes of any incomplete
+			trailing sequence, which are held by the decoder until the rest of the sequence is provided. Throws if the encoding is not supported. */
+		uint32_t decode(const char* src, size_t numBytes, char32_t* dest, uint32_t maxChars, size_t& bytesConsumed);
+
+		/*	Completes decoding once the end of the input is reached. If an incomplete sequence is still pending,
+			a replacement character is written to dest and 1 is returned. Otherwise, returns 0. */
+		uint32_t flush(char32_t* dest);
+
+		/* Discards any pending partial sequence. */
+		void reset();
+
+		/* Returns true if the decoder is holding an incomplete sequence from a previous call to decode(). */
+		bool hasPending() const;
+
+		inline UtfEncoding getEncoding() const { return _encoding; }
+
+	private:
+		const static char32_t REPLACEMENT_CHAR;
+
+		uint32_t decodeUtf8(const uint8_t* src, size_t numBytes, char32_t* dest, uint32_t maxChars, size_t& bytesConsumed);
+		uint32_t decodeUtf16(const uint8_t* src, size_t numBytes, char32_t* dest, uint32_t maxChars, size_t& bytesConsumed, bool bigEndian);
+
+		UtfEncoding _encoding;
+		char32_t _pending;			/* Code point bits collected so far from an incomplete UTF-8 sequence. */
+		char32_t _pending_min;		/* The smallest code point the pending UTF-8 sequence may legally encode. Anything lower is overlong. */
+		uint8_t _pending_needed;	/* Number of UTF-8 continuation bytes still required to complete the pending sequence. */
+		uint8_t _pending_byte;		/* The first byte of an incomplete UTF-16 code unit. */
+		bool _has_pending_byte;
+		char16_t _high_surrogate;	/* A UTF-16 high surrogate waiting for its low surrogate, or 0 if none. */
+	};
+}
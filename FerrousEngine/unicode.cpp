@@ -0,0 +1,56 @@
+#include "unicode.h"
+
+namespace fe {
+#ifdef FE_SSE2
+	/*	Converts 4 characters at a time while they are all ASCII, by adding or subtracting 32 from every lane that falls within [first, last].
+		Returns the index of the first character which was not converted. */
+	static uint32_t convertAsciiCase(const char32_t* src, char32_t* dest, uint32_t count, char32_t first, char32_t last, int32_t delta) {
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i below = _mm_set1_epi32(first - 1);
+		const __m128i above = _mm_set1_epi32(last + 1);
+		const __m128i offset = _mm_set1_epi32(delta);
+		uint32_t i = 0;
+
+		for (; count - i >= 4; i += 4) {
+			__m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+
+			// Any bits set above the first 7 means at least one character is not ASCII.
+			if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_srli_epi32(c, 7), zero)) != 0xFFFF)
+				break;
+
+			__m128i in_range = _mm_and_si128(_mm_cmpgt_epi32(c, below), _mm_cmplt_epi32(c, above));
+			c = _mm_add_epi32(c, _mm_and_si128(in_range, offset));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), c);
+		}
+
+		return i;
+	}
+#endif
+
+	void Unicode::toLower(const char32_t* src, char32_t* dest, uint32_t count) {
+		uint32_t i = 0;
+
+		while (i < count) {
+#ifdef FE_SSE2
+			i += convertAsciiCase(src + i, dest + i, count - i, U'A', U'Z', 32);
+#endif
+			// Convert at least one character, so a non-ASCII block cannot stall the SIMD loop.
+			uint32_t end = min(i + 4, count);
+			for (; i < end; i++)
+				dest[i] = toLower(src[i]);
+		}
+	}
+
+	void Unicode::toUpper(const char32_t* src, char32_t* dest, uint32_t count) {
+		uint32_t i = 0;
+
+		while (i < count) {
+#ifdef FE_SSE2
+			i += convertAsciiCase(src + i, dest + i, count - i, U'a', U'z', -32);
+#endif
+			uint32_t end = min(i + 4, count);
+			for (; i < end; i++)
+				dest[i] = toUpper(src[i]);
+		}
+	}
+}
@@ -0,0 +1,114 @@
+#pragma once
+#include "stdafx.h"
+
+namespace fe {
+	/* Unicode general categories. See: https://www.unicode.org/reports/tr44/#General_Category_Values */
+	enum class UnicodeCategory : uint8_t {
+		Unassigned = 0,				/* Cn */
+		UppercaseLetter = 1,		/* Lu */
+		LowercaseLetter = 2,		/* Ll */
+		TitlecaseLetter = 3,		/* Lt */
+		ModifierLetter = 4,			/* Lm */
+		OtherLetter = 5,			/* Lo */
+		NonSpacingMark = 6,			/* Mn */
+		SpacingMark = 7,			/* Mc */
+		EnclosingMark = 8,			/* Me */
+		DecimalNumber = 9,			/* Nd */
+		LetterNumber = 10,			/* Nl */
+		OtherNumber = 11,			/* No */
+		ConnectorPunctuation = 12,	/* Pc */
+		DashPunctuation = 13,		/* Pd */
+		OpenPunctuation = 14,		/* Ps */
+		ClosePunctuation = 15,		/* Pe */
+		InitialPunctuation = 16,	/* Pi */
+		FinalPunctuation = 17,		/* Pf */
+		OtherPunctuation = 18,		/* Po */
+		MathSymbol = 19,			/* Sm */
+		CurrencySymbol = 20,		/* Sc */
+		ModifierSymbol = 21,		/* Sk */
+		OtherSymbol = 22,			/* So */
+		SpaceSeparator = 23,		/* Zs */
+		LineSeparator = 24,			/* Zl */
+		ParagraphSeparator = 25,	/* Zp */
+		Control = 26,				/* Cc */
+		Format = 27,				/* Cf */
+		Surrogate = 28,				/* Cs */
+		PrivateUse = 29,			/* Co */
+	};
+
+	/*	Culture-invariant Unicode character data, backed by two-stage lookup tables generated from the Unicode Character Database.
+		Code points beyond U+10FFFF are treated as unassigned and map to themselves. */
+	class Unicode {
+	public:
+		static constexpr char32_t MAX_CODEPOINT = 0x10FFFF;
+
+		/* Returns the simple lower-case mapping of a character, or the character itself if it has none. */
+		static inline char32_t toLower(const char32_t c) {
+			return c + getRecord(c).lowerDelta;
+		}
+
+		/* Returns the simple upper-case mapping of a character, or the character itself if it has none. */
+		static inline char32_t toUpper(const char32_t c) {
+			return c + getRecord(c).upperDelta;
+		}
+
+		/* Returns the simple case folding of a character, for case-insensitive comparison. */
+		static inline char32_t fold(const char32_t c) {
+			return toLower(toUpper(c));
+		}
+
+		static inline UnicodeCategory getCategory(const char32_t c) {
+			return static_cast<UnicodeCategory>(getRecord(c).category);
+		}
+
+		/* Returns true if the character has the Unicode White_Space property. */
+		static inline bool isWhitespace(const char32_t c) {
+			return (getRecord(c).flags & FLAG_WHITESPACE) != 0;
+		}
+
+		/* Returns true if the character is a space separator (Zs), such as a space or no-break space. */
+		static inline bool isSpace(const char32_t c) {
+			return getCategory(c) == UnicodeCategory::SpaceSeparator;
+		}
+
+		static inline bool isLetter(const char32_t c) {
+			UnicodeCategory cat = getCategory(c);
+			return cat >= UnicodeCategory::UppercaseLetter && cat <= UnicodeCategory::OtherLetter;
+		}
+
+		static inline bool isDigit(const char32_t c) {
+			return getCategory(c) == UnicodeCategory::DecimalNumber;
+		}
+
+		/* Converts count characters from src to lower-case and stores them in dest. src and dest may be the same. */
+		static void toLower(const char32_t* src, char32_t* dest, uint32_t count);
+
+		/* Converts count characters from src to upper-case and stores them in dest. src and dest may be the same. */
+		static void toUpper(const char32_t* src, char32_t* dest, uint32_t count);
+
+	private:
+		struct Record {
+			int32_t lowerDelta;
+			int32_t upperDelta;
+			uint8_t category;
+			uint8_t flags;
+		};
+
+		static constexpr uint32_t BLOCK_SHIFT = 8;
+		static constexpr uint32_t BLOCK_MASK = (1 << BLOCK_SHIFT) - 1;
+		static constexpr uint8_t FLAG_WHITESPACE = 1;
+
+		/* Generated by tools/generate_unicode_tables.py. See unicode_tables.cpp. */
+		const static Record RECORDS[];
+		const static uint8_t STAGE1[];
+		const static uint8_t STAGE2[];
+
+		static inline const Record& getRecord(const char32_t c) {
+			if (c > MAX_CODEPOINT)
+				return RECORDS[0];
+
+			uint32_t block = STAGE1[c >> BLOCK_SHIFT];
+			return RECORDS[STAGE2[(block << BLOCK_SHIFT) | (c & BLOCK_MASK)]];
+		}
+	};
+}
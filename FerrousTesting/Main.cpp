@@ -10,6 +10,12 @@
 #include "test_shapes.hpp"
 #include "test_io.hpp"
 #include "test_engine.h"
+#include "test_jobs.hpp"
+#include "test_parallel.hpp"
+#include "test_concurrent.hpp"
+#include "test_game_time.hpp"
+#include "test_collections.hpp"
+#include "test_coroutines.hpp"
 
 #include "logging_console.h"
 #include <logging_file.h>
@@ -49,6 +55,14 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE, LPSTR, int nShowCmd) {
 
 	createAndRunTest<TestMemory>(log);
 	createAndRunTest<TestStrings>(log);
+	createAndRunTest<TestCollections>(log);
+	createAndRunTest<TestJobs>(log);
+	createAndRunTest<TestParallel>(log);
+	createAndRunTest<TestConcurrent>(log);
+	createAndRunTest<TestGameTime>(log);
+#ifdef FE_COROUTINES
+	createAndRunTest<TestCoroutines>(log);
+#endif
 	//createAndRunTest<TestShapes>(log);
 	//createAndRunTest<TestIO>(log);
 
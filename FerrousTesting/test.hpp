@@ -18,11 +18,28 @@ public:
 		log.writeLine(title, Color::limeGreen);
 		log.writeLine(FeString::repeat("=", 20 + title.len()), Color::limeGreen);
 		onRun(log);
+		if (failures > 0)
+			log.writeLine(FeString::format("%d checks failed"_fe, failures), Color::red);
+
 		log.writeLine(" ");
 	}
 
 	const FeString title;
+	int failures = 0;
 
 protected:
 	virtual void onRun(Logger& log) = 0;
+
+	/* Writes whether a single check passed, and counts it if it failed. Returns passed. */
+	bool check(Logger& log, bool passed, const FeString& label) {
+		if (passed) {
+			log.writeLine("PASS: "_fe + label, Color::limeGreen);
+		}
+		else {
+			log.writeLine("FAIL: "_fe + label, Color::red);
+			failures++;
+		}
+
+		return passed;
+	}
 };
\ No newline at end of file
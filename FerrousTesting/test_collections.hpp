@@ -0,0 +1,469 @@
+#pragma once
+#include "stdafx.h"
+#include "test.hpp"
+#include "list.h"
+#include "bit_array.h"
+#include "dictionary.h"
+#include "slot_map.h"
+#include "flat_map.h"
+#include "flat_set.h"
+#include "priority_queue.h"
+#include "intrusive_list.h"
+#include "deque.h"
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+
+class TestCollections : public FerrousTest {
+public:
+
+	TestCollections() : FerrousTest("Collections Test") {}
+
+protected:
+	/* Counts live instances, so tests can check that containers destroy exactly what they construct. */
+	struct Tracked {
+		static inline int live = 0;
+		int value;
+
+		Tracked(int v = 0) : value(v) { live++; }
+		Tracked(const Tracked& other) : value(other.value) { live++; }
+		~Tracked() { live--; }
+
+		Tracked& operator=(const Tracked& other) = default;
+		bool operator==(const Tracked& other) const { return value == other.value; }
+	};
+
+	void onRun(Logger& log) override {
+		testList(log);
+		testIterators(log);
+		testDictionary(log);
+		testSlotMap(log);
+		testSmallList(log);
+		testFlatMap(log);
+		testPriorityQueue(log);
+		testIntrusiveList(log);
+		testDeque(log);
+		testBits(log);
+	}
+
+	void testList(Logger& log) {
+		{
+			List<Tracked> list;
+			for (int i = 0; i < 100; i++)
+				list.add(Tracked(i));
+
+			uint32_t calls = 0;
+			uint32_t removed = list.removeIf([&calls](const Tracked& item) {
+				calls++;
+				return item.value % 3 == 0 || (item.value >= 40 && item.value < 50);
+			});
+
+			bool ordered = list.count() == 100 - removed;
+			for (uint32_t i = 0; i < list.count(); i++) {
+				int value = list[i].value;
+				ordered = ordered && value % 3 != 0 && (value < 40 || value >= 50) && (i == 0 || list[i - 1].value < value);
+			}
+
+			check(log, calls == 100, "removeIf() calls the predicate once per item"_fe);
+			check(log, removed == 41 && ordered, "removeIf() keeps the remaining items in order"_fe);
+			check(log, Tracked::live == (int)list.count(), "removeIf() destroys each removed item"_fe);
+
+			list.add(Tracked(1));
+			list.add(Tracked(1));
+			check(log, list.removeAll(list[0]) == 3 && list.count() == 58, "removeAll() removes every copy, even of an item in the list"_fe);
+
+			list.swapRemove(0);
+			check(log, list.count() == 57 && list[0].value == 98, "swapRemove() moves the last item into the gap"_fe);
+
+			Tracked block[3] = { Tracked(-1), Tracked(-2), Tracked(-3) };
+			list.insertRange(1, block, 3);
+			check(log, list.count() == 60 && list[1].value == -1 && list[3].value == -3 && list[4].value == 4, "insertRange() inserts a block in place"_fe);
+
+			list.resize(10);
+			list.resize(12, Tracked(7));
+			check(log, list.count() == 12 && list[11].value == 7 && Tracked::live == 12 + 3, "resize() constructs and destroys the difference"_fe);
+
+			list.reserve(200);
+			check(log, list.capacity() >= 200 && list.count() == 12, "reserve() grows without changing the items"_fe);
+		}
+
+		check(log, Tracked::live == 0, "List destroys its items"_fe);
+	}
+
+	void testBits(Logger& log) {
+		BitSet<300> set;
+		set.set(0);
+		set.set(129);
+		set.set(299);
+		uint32_t sum = 0;
+		set.forEachSet([&sum](uint32_t i) { sum += i; });
+		check(log, set.countSet() == 3 && set.findNextSet(1) == 129 && sum == 428, "BitSet finds and visits set bits"_fe);
+
+		BitArray a(1000);
+		BitArray b(1000);
+		a.setRange(100, 200);
+		b.setRange(250, 100);
+		BitArray both = a;
+		both.andWith(b);
+		a.orWith(b);
+		check(log, both.countSet() == 50 && both.findNextSet() == 250 && a.countSet() == 250, "BitArray combines arrays of the same size"_fe);
+
+		// An array which shrank keeps its larger allocation, so only the words in use may be combined or compared.
+		BitArray shrunk(1000);
+		shrunk.resize(10);
+		BitArray small(10);
+		small.set(3);
+		shrunk.orWith(small);
+		check(log, shrunk == small, "A shrunk BitArray combines with a smaller one"_fe);
+
+		bool threw = false;
+		try {
+			a.andWith(small);
+		}
+		catch (const IndexOutOfRangeExeption&) {
+			threw = true;
+		}
+		check(log, threw, "Combining BitArrays of different sizes throws"_fe);
+	}
+
+	void testIterators(Logger& log) {
+		using Iterator = List<int>::iterator;
+		using ConstIterator = List<int>::const_iterator;
+		static_assert(std::is_same<std::iterator_traits<Iterator>::iterator_category, std::random_access_iterator_tag>::value, "List iterators must be random access.");
+		static_assert(std::is_same<std::iterator_traits<ConstIterator>::reference, const int&>::value, "List const iterators must be read-only.");
+		static_assert(std::is_convertible<Iterator, ConstIterator>::value && !std::is_convertible<ConstIterator, Iterator>::value, "Only mutable iterators convert.");
+#if __cplusplus >= 202002L || (defined(_MSVC_LANG) && _MSVC_LANG >= 202002L)
+		static_assert(std::contiguous_iterator<Iterator> && std::contiguous_iterator<ConstIterator>, "List iterators must be contiguous.");
+#endif
+
+		List<int> list;
+		for (int i = 0; i < 100; i++)
+			list.add((i * 37) % 100);
+
+		std::sort(list.begin(), list.end());
+		const List<int>& constList = list;
+		bool sorted = std::is_sorted(constList.begin(), constList.end()) && *std::lower_bound(list.cbegin(), list.cend(), 42) == 42;
+		check(log, sorted, "std::sort and std::lower_bound work on a List"_fe);
+
+		int reversed = 0;
+		for (auto it = list.rbegin(); it != list.rend(); ++it)
+			reversed = reversed * 2 % 1000003 + *it;
+
+		int expected = 0;
+		for (int i = 99; i >= 0; i--)
+			expected = expected * 2 % 1000003 + i;
+
+		check(log, reversed == expected && std::accumulate(list.begin(), list.end(), 0) == 4950, "Reverse and forward iteration visit every item"_fe);
+
+		Iterator it = list.begin() + 10;
+		ConstIterator cit = list.cbegin() + 10;
+		bool mixed = it == cit && cit == it && !(it != cit) && !(cit != it);
+		mixed = mixed && it < list.cend() && list.cbegin() < it && cit <= it && it >= cit && list.cend() > it;
+		mixed = mixed && list.cend() - it == 90 && it - list.cbegin() == 10 && cit - list.begin() == 10;
+		check(log, mixed, "Mutable and read-only iterators compare and subtract in either order"_fe);
+	}
+
+	void testDictionary(Logger& log) {
+		{
+			Dictionary<uint32_t, Tracked> map;
+			for (uint32_t i = 0; i < 300; i++)
+				map.put(i, Tracked((int)i * 2));
+
+			bool grown = map.count() == 300 && map.capacity() == 512 && Tracked::live == 300;
+			for (uint32_t i = 0; i < 300; i++)
+				grown = grown && map.get(i).value == (int)i * 2;
+			check(log, grown, "Dictionary grows and rehashes as entries are added"_fe);
+
+			Dictionary<uint32_t, Tracked> copy(map);
+			copy.put(0, Tracked(-1));
+			Dictionary<uint32_t, Tracked> moved(std::move(map));
+			bool copies = copy.count() == 300 && moved.count() == 300 && map.count() == 0 && copy.get(0).value == -1 && moved.get(0).value == 0;
+			check(log, copies && !map.containsKey(1) && Tracked::live == 600, "Dictionary copies and moves"_fe);
+
+			map = copy;
+			copy.clear();
+			bool assigned = map.count() == 300 && copy.count() == 0 && Tracked::live == 600;
+			check(log, assigned && map.get(299).value == 598 && !copy.containsKey(299), "Dictionary assigns and clears"_fe);
+		}
+
+		check(log, Tracked::live == 0, "Dictionary destroys its values"_fe);
+
+		// Removed entries leave tombstones, which are reused or purged rather than growing the table.
+		Dictionary<uint32_t, uint32_t> reused(200);
+		for (uint32_t i = 0; i < 100; i++)
+			reused.put(i, i);
+
+		uint32_t capacity = reused.capacity();
+		for (uint32_t round = 1; round <= 5; round++) {
+			for (uint32_t i = 0; i < 100; i++) {
+				reused.remove((round - 1) * 100 + i);
+				reused.put(round * 100 + i, i);
+			}
+		}
+
+		uint32_t value = 0;
+		bool found = reused.tryGet(599, value) && value == 99 && !reused.tryGet(499, value) && !reused.remove(0u);
+		check(log, found && reused.count() == 100 && reused.capacity() == capacity, "Dictionary reuses the slots of removed entries"_fe);
+
+		Dictionary<FeString, int> names;
+		names.put("alpha"_fe, 1);
+		names.put("beta"_fe, 2);
+		names.put("gamma"_fe, 0);
+		names["gamma"_fe] = 3;
+		uint64_t hash = DefaultKeyHash<FeString>()("beta"_fe);
+		bool lookups = names.containsKey(FeStringView(U"alpha", 5)) && names.get(FeStringView(U"gamma", 5)) == 3;
+		lookups = lookups && names.get(PrehashedKey<FeString>{ "beta"_fe, hash }) == 2 && names.remove(FeStringView(U"alpha", 5));
+		check(log, lookups && names.count() == 2 && !names.containsKey("alpha"_fe), "Dictionary<FeString> can be queried with a string view or a precomputed hash"_fe);
+
+		// A load factor below one entry per group must still let the table grow.
+		Dictionary<uint32_t, uint32_t> sparse(0, Memory::get(), 0.05f);
+		for (uint32_t i = 0; i < 20; i++)
+			sparse.put(i, i + 1);
+
+		bool sparseFound = sparse.count() == 20 && sparse.capacity() * 0.05f >= 20.0f;
+		for (uint32_t i = 0; i < 20; i++)
+			sparseFound = sparseFound && sparse.get(i) == i + 1;
+		check(log, sparseFound, "Dictionary grows with a very low load factor"_fe);
+	}
+
+	void testSlotMap(Logger& log) {
+		{
+			SlotMap<Tracked> map;
+			SlotHandle handles[100];
+			for (int i = 0; i < 100; i++)
+				handles[i] = map.add(Tracked(i));
+
+			for (int i = 0; i < 100; i += 2)
+				map.remove(handles[i]);
+
+			bool found = map.count() == 50;
+			for (int i = 0; i < 100; i++)
+				found = found && map.contains(handles[i]) == (i % 2 == 1) && (i % 2 == 0 || map.get(handles[i]).value == i);
+
+			check(log, found, "SlotMap handles still find their items after others are removed"_fe);
+
+			int sum = 0;
+			for (const Tracked& item : map)
+				sum += item.value;
+
+			check(log, sum == 2500 && map.items().count() == 50, "SlotMap keeps its items dense"_fe);
+
+			// A reused slot gets a new generation, so the old handle stays invalid.
+			SlotHandle reused = map.add(Tracked(-1));
+			bool stale = reused.index() == handles[98].index() && reused != handles[98] && !map.contains(handles[98]) && map.tryGet(handles[98]) == nullptr;
+
+			bool threw = false;
+			try {
+				map.get(handles[0]);
+			}
+			catch (const char*) {
+				threw = true;
+			}
+
+			check(log, stale && threw, "A removed item's handle stays invalid after its slot is reused"_fe);
+
+			map.clear();
+			check(log, map.isEmpty() && !map.contains(handles[1]) && !map.contains(reused) && Tracked::live == 0, "clear() destroys every item and invalidates every handle"_fe);
+		}
+
+		check(log, Tracked::live == 0, "SlotMap destroys its items"_fe);
+	}
+
+	void testSmallList(Logger& log) {
+		{
+			SmallList<Tracked, 4> list;
+			for (int i = 0; i < 4; i++)
+				list.add(Tracked(i));
+
+			bool inlineFirst = list.isInline() && list.capacity() == 4;
+			list.add(Tracked(4));
+			check(log, inlineFirst && !list.isInline() && list.count() == 5 && list[4].value == 4, "SmallList stores items inline until it outgrows its inline capacity"_fe);
+
+			list.removeAt(0);
+			list.removeAt(0);
+			list.trim();
+			check(log, list.isInline() && list.count() == 3 && list[0].value == 2 && list[2].value == 4, "trim() moves items back inline once they fit"_fe);
+
+			SmallList<Tracked, 4> copy(list);
+			SmallList<Tracked, 4> moved(std::move(list));
+			bool copies = copy.isInline() && moved.isInline() && copy[1].value == 3 && moved[1].value == 3 && list.count() == 0;
+			check(log, copies && Tracked::live == 6, "SmallList copies and moves inline items"_fe);
+
+			for (int i = 0; i < 10; i++)
+				moved.add(Tracked(i));
+
+			SmallList<Tracked, 4> grown(std::move(moved));
+			check(log, grown.count() == 13 && !grown.isInline() && grown[12].value == 9, "Moving a spilled SmallList takes its allocation"_fe);
+		}
+
+		check(log, Tracked::live == 0, "SmallList destroys its items"_fe);
+	}
+
+	void testFlatMap(Logger& log) {
+		FlatMap<int, int> map = { { 5, 50 }, { 1, 10 }, { 3, 30 }, { 5, 55 }, { 9, 90 } };
+		Span<const int> keys = map.keys();
+		bool built = map.count() == 4 && keys[0] == 1 && keys[1] == 3 && keys[2] == 5 && keys[3] == 9 && map.get(5) == 55;
+		check(log, built, "FlatMap builds sorted, with the last duplicate winning"_fe);
+
+		map.put(4, 40);
+		map.put(3, 33);
+		map.put(7, 0);
+		map[7] = 70;
+		bool updated = map.remove(1) && !map.remove(2) && map.count() == 5 && map.get(3) == 33 && map.values()[1] == 40;
+		Span<int> range = map.valuesInRange(4, 7);
+		check(log, updated && range.count() == 3 && range[0] == 40 && range[2] == 70, "FlatMap stays sorted through put, remove and range queries"_fe);
+
+		int missing = 0;
+		bool threw = false;
+		try {
+			map.get(2);
+		}
+		catch (const char*) {
+			threw = true;
+		}
+		check(log, threw && !map.tryGet(2, missing) && map.lowerBound(6) == 3 && map.upperBound(9) == 5, "FlatMap reports missing keys"_fe);
+
+		FlatMap<FeString, int> names = { { "beta"_fe, 2 }, { "alpha"_fe, 1 } };
+		check(log, names.containsKey(FeStringView(U"alpha", 5)) && names.get(FeStringView(U"beta", 4)) == 2, "FlatMap<FeString> can be queried with a string view"_fe);
+
+		FlatSet<int> set = { 4, 2, 4, 8, 6 };
+		bool setOk = set.count() == 4 && !set.add(2) && set.add(5) && set.remove(8) && set.contains(5) && !set.contains(8);
+		Span<const int> setRange = set.range(3, 6);
+		check(log, setOk && setRange.count() == 3 && setRange[0] == 4 && setRange[2] == 6, "FlatSet keeps unique keys in order"_fe);
+	}
+
+	struct Greater {
+		inline bool operator()(int a, int b) const { return a > b; }
+	};
+
+	void testPriorityQueue(Logger& log) {
+		int values[200];
+		uint32_t seed = 12345;
+		for (int i = 0; i < 200; i++) {
+			seed = seed * 1664525u + 1013904223u;
+			values[i] = (int)(seed >> 16) % 1000;
+		}
+
+		PriorityQueue<int> queue(values, 200);
+		int previous = -1;
+		bool ordered = queue.count() == 200;
+		while (!queue.isEmpty()) {
+			int item = queue.pop();
+			ordered = ordered && item >= previous;
+			previous = item;
+		}
+		check(log, ordered, "PriorityQueue built from a range pops in order"_fe);
+
+		SlotHandle handles[50];
+		for (int i = 0; i < 50; i++)
+			handles[i] = queue.push(100 + i * 10);
+
+		bool changed = queue.decreaseKey(handles[30], 5) && queue.top() == 5;
+		changed = changed && queue.update(handles[30], 1000) && queue.top() == 100 && queue.get(handles[30]) == 1000;
+		changed = changed && queue.update(handles[0], 50) && queue.remove(handles[0]) && !queue.contains(handles[0]) && !queue.remove(handles[0]);
+		check(log, changed && queue.top() == 110 && queue.count() == 49, "PriorityQueue handles follow their items through update and remove"_fe);
+
+		int item = 0;
+		previous = -1;
+		ordered = true;
+		while (queue.tryPop(item)) {
+			ordered = ordered && item >= previous;
+			previous = item;
+		}
+		check(log, ordered && previous == 1000 && !queue.contains(handles[30]) && !queue.update(handles[1], 0), "Popped items invalidate their handles"_fe);
+
+		PriorityQueue<int, Greater, 2> maxQueue;
+		for (int i = 0; i < 200; i++)
+			maxQueue.push(values[i]);
+
+		previous = 1000;
+		ordered = true;
+		while (!maxQueue.isEmpty()) {
+			int next = maxQueue.pop();
+			ordered = ordered && next <= previous;
+			previous = next;
+		}
+
+		bool threw = false;
+		try {
+			maxQueue.pop();
+		}
+		catch (const IndexOutOfRangeExeption&) {
+			threw = true;
+		}
+		check(log, ordered && threw, "PriorityQueue honours its comparer and arity"_fe);
+	}
+
+	struct Linked {
+		int value;
+		IntrusiveListNode node;
+	};
+
+	void testIntrusiveList(Logger& log) {
+		Linked items[5] = { { 0 }, { 1 }, { 2 }, { 3 }, { 4 } };
+		IntrusiveList<Linked, &Linked::node> list;
+		list.pushBack(items[1]);
+		list.pushBack(items[3]);
+		list.pushFront(items[0]);
+		list.insertBefore(items[3], items[2]);
+		list.insertAfter(items[3], items[4]);
+
+		int expected = 0;
+		bool ordered = list.count() == 5;
+		for (Linked& item : list)
+			ordered = ordered && item.value == expected++;
+		check(log, ordered && expected == 5, "IntrusiveList links items in place"_fe);
+
+		list.moveToFront(items[4]);
+		list.moveToBack(items[0]);
+		list.remove(items[2]);
+		IntrusiveList<Linked, &Linked::node>::iterator last = list.end();
+		--last;
+		bool moved = list.front() == &items[4] && list.back() == &items[0] && last->value == 0 && !items[2].node.isLinked() && list.count() == 4;
+		check(log, moved, "IntrusiveList moves and removes items in O(1)"_fe);
+
+		bool popped = list.popFront() == &items[4] && list.popBack() == &items[0] && list.count() == 2;
+		list.clear();
+		bool cleared = list.isEmpty() && list.popFront() == nullptr && list.front() == nullptr && !items[1].node.isLinked() && !items[3].node.isLinked();
+		check(log, popped && cleared, "IntrusiveList unlinks items when popped or cleared"_fe);
+	}
+
+	void testDeque(Logger& log) {
+		{
+			const int total = (int)Deque<Tracked>::CHUNK_ITEMS * 3;
+			Deque<Tracked> deque;
+			for (int i = 0; i < total; i++) {
+				deque.pushBack(Tracked(i));
+				deque.pushFront(Tracked(-1 - i));
+			}
+
+			bool indexed = deque.count() == (uint32_t)total * 2 && deque.front().value == -total && deque.back().value == total - 1;
+			for (int i = 0; i < total * 2; i++)
+				indexed = indexed && deque[i].value == i - total;
+			check(log, indexed && Tracked::live == total * 2, "Deque grows at both ends across chunks"_fe);
+
+			bool popped = true;
+			for (int i = 0; i < total; i++) {
+				popped = popped && deque.popFront().value == i - total;
+				popped = popped && deque.popBack().value == total - 1 - i;
+			}
+			Tracked item;
+			check(log, popped && deque.isEmpty() && !deque.tryPopFront(item) && !deque.tryPopBack(item), "Deque pops from both ends in order"_fe);
+
+			for (int i = 0; i < 100; i++)
+				deque.pushBack(Tracked(i));
+
+			Deque<Tracked> copy(deque);
+			copy.popFront();
+			int sum = 0;
+			for (const Tracked& t : copy)
+				sum += t.value;
+			check(log, deque.count() == 100 && copy.count() == 99 && sum == 4950 && deque[0].value == 0, "Deque copies are independent"_fe);
+
+			deque.clear();
+			check(log, deque.isEmpty() && Tracked::live == 100, "Deque clear() destroys its items"_fe);
+		}
+
+		check(log, Tracked::live == 0, "Deque destroys its items"_fe);
+	}
+};
\ No newline at end of file
@@ -0,0 +1,239 @@
+#pragma once
+#include "stdafx.h"
+#include "test.hpp"
+#include "concurrent_dictionary.h"
+#include "concurrent_mpmc_queue.h"
+#include "concurrent_spsc_queue.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+class TestConcurrent : public FerrousTest {
+public:
+
+	TestConcurrent() : FerrousTest("Concurrent Collections Test") {}
+
+protected:
+	const static uint32_t NUM_THREADS = 4;
+	const static uint32_t KEYS_PER_THREAD = 5000;
+
+	void onRun(Logger& log) override {
+		testDictionary(log);
+		testQueues(log);
+	}
+
+	void testDictionary(Logger& log) {
+		// A single shard, so its table must grow past one block of slots.
+		ConcurrentDictionary<FeString, uint32_t> names(1);
+		for (uint32_t i = 0; i < 2000; i++)
+			names.put("name "_fe + i, i);
+
+		bool allFound = names.count() == 2000;
+		for (uint32_t i = 0; i < 2000; i++)
+			allFound = allFound && names.get("name "_fe + i) == i;
+
+		check(log, allFound, "A shard holds more entries than fit in one page"_fe);
+
+		for (uint32_t i = 0; i < 2000; i += 2)
+			names.remove("name "_fe + i);
+
+		check(log, names.count() == 1000 && !names.containsKey("name 10"_fe) && names.containsKey("name 11"_fe), "remove() only removes its key"_fe);
+
+		// Writers on every thread, each with its own keys, while all of them read the others' keys.
+		ConcurrentDictionary<uint32_t, uint32_t> map;
+		std::atomic<uint32_t> wrongValues = 0;
+		std::vector<std::thread> threads;
+		for (uint32_t t = 0; t < NUM_THREADS; t++) {
+			threads.emplace_back([&map, &wrongValues, t] {
+				for (uint32_t i = 0; i < KEYS_PER_THREAD; i++) {
+					uint32_t key = t * KEYS_PER_THREAD + i;
+					map.put(key, key * 2);
+
+					uint32_t other = ((t + 1) % NUM_THREADS) * KEYS_PER_THREAD + i;
+					uint32_t value = 0;
+					if (map.tryGet(other, value) && value != other * 2)
+						wrongValues.fetch_add(1, std::memory_order_relaxed);
+				}
+			});
+		}
+
+		for (std::thread& thread : threads)
+			thread.join();
+
+		check(log, map.count() == NUM_THREADS * KEYS_PER_THREAD && wrongValues.load() == 0, "Concurrent put() and tryGet() see only complete entries"_fe);
+
+		// Every thread asks for the same keys; each value must be created exactly once.
+		ConcurrentDictionary<uint32_t, uint32_t> created;
+		std::atomic<uint32_t> createCalls = 0;
+		std::atomic<uint32_t> mismatches = 0;
+		threads.clear();
+		for (uint32_t t = 0; t < NUM_THREADS; t++) {
+			threads.emplace_back([&created, &createCalls, &mismatches, t] {
+				for (uint32_t key = 0; key < 1000; key++) {
+					uint32_t value = created.getOrAdd(key, [&createCalls, key, t] {
+						createCalls.fetch_add(1, std::memory_order_relaxed);
+						return key + 1;
+					});
+
+					if (value != key + 1)
+						mismatches.fetch_add(1, std::memory_order_relaxed);
+				}
+			});
+		}
+
+		for (std::thread& thread : threads)
+			thread.join();
+
+		check(log, createCalls.load() == 1000 && mismatches.load() == 0, "getOrAdd() creates each value once"_fe);
+
+		// Two dictionaries of strings, written and read by every thread, so keys and values are allocated, copied and freed on all of them.
+		ConcurrentDictionary<FeString, FeString> first;
+		ConcurrentDictionary<FeString, FeString> second;
+		std::atomic<uint32_t> wrongStrings = 0;
+		threads.clear();
+		for (uint32_t t = 0; t < NUM_THREADS; t++) {
+			threads.emplace_back([&first, &second, &wrongStrings, t] {
+				for (uint32_t i = 0; i < 1000; i++) {
+					ConcurrentDictionary<FeString, FeString>& target = (i % 2 == 0) ? first : second;
+					uint32_t key = t * 1000 + i;
+					target.put("key "_fe + key, "value "_fe + key);
+
+					uint32_t other = ((t + 1) % NUM_THREADS) * 1000 + i;
+					FeString value;
+					if (target.tryGet("key "_fe + other, value) && value != "value "_fe + other)
+						wrongStrings.fetch_add(1, std::memory_order_relaxed);
+
+					if (i % 4 == 0)
+						target.remove("key "_fe + key);
+				}
+			});
+		}
+
+		for (std::thread& thread : threads)
+			thread.join();
+
+		bool stringsFound = first.get("key 10"_fe) == "value 10"_fe && second.get("key 1"_fe) == "value 1"_fe && !first.containsKey("key 0"_fe);
+		check(log, stringsFound && first.count() + second.count() == NUM_THREADS * 750 && wrongStrings.load() == 0, "Dictionaries of strings can be used from several threads at once"_fe);
+	}
+
+	void testQueues(Logger& log) {
+		// Queues larger than one page store their items in several page-sized blocks.
+		MpmcQueue<int> large(5000);
+		SpscQueue<uint64_t> largeRing(20000);
+		uint32_t pushed = 0;
+		while (large.tryPush((int)pushed))
+			pushed++;
+
+		bool inOrder = pushed == 8192 && large.capacity() == 8192;
+		for (int i = 0, item = -1; i < 8192; i++)
+			inOrder = inOrder && large.tryPop(item) && item == i;
+
+		for (uint64_t i = 0; i < 20000; i++)
+			inOrder = inOrder && largeRing.tryPush(i);
+
+		uint64_t ringItem = 0;
+		for (uint64_t i = 0; i < 20000; i++)
+			inOrder = inOrder && largeRing.tryPop(ringItem) && ringItem == i;
+
+		check(log, inOrder && largeRing.capacity() == 32768 && MpmcQueue<int>::MAX_CAPACITY >= 65536, "Queues can hold more items than fit in one page"_fe);
+
+		bool threw = false;
+		try {
+			MpmcQueue<int> tooLarge(MpmcQueue<int>::MAX_CAPACITY + 1);
+		}
+		catch (const IndexOutOfRangeExeption&) {
+			threw = true;
+		}
+		check(log, threw, "A queue larger than MAX_CAPACITY throws"_fe);
+
+		// Batches stop at the first cell which is not ready, rather than failing outright.
+		MpmcQueue<int> queue(8);
+		int values[10] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+		int popped[10] = {};
+		bool batches = queue.tryPushBatch(values, 5) == 5 && queue.tryPushBatch(values + 5, 5) == 3 && queue.tryPushBatch(values, 1) == 0;
+		batches = batches && queue.tryPopBatch(popped, 6) == 6 && queue.tryPopBatch(popped + 6, 4) == 2 && queue.tryPopBatch(popped, 1) == 0;
+		check(log, batches && popped[5] == 5 && popped[7] == 7, "Batches push and pop up to the queue's capacity"_fe);
+
+		// Producers and consumers race with both single and batch operations. A batch must only come back short
+		// when the queue is really full or empty, so every item gets through and none is duplicated.
+		const uint32_t itemsPerProducer = 20000;
+		MpmcQueue<uint32_t> shared(64);
+		std::atomic<uint64_t> sum = 0;
+		std::atomic<uint32_t> received = 0;
+		std::vector<std::thread> threads;
+		for (uint32_t t = 0; t < NUM_THREADS / 2; t++) {
+			threads.emplace_back([&shared, t, itemsPerProducer] {
+				uint32_t batch[8];
+				for (uint32_t i = 0; i < itemsPerProducer;) {
+					uint32_t pushed;
+					if (t % 2 == 0) {
+						pushed = shared.tryPush(i + 1) ? 1 : 0;
+					}
+					else {
+						uint32_t count = itemsPerProducer - i < 8 ? itemsPerProducer - i : 8;
+						for (uint32_t b = 0; b < count; b++)
+							batch[b] = i + b + 1;
+
+						pushed = shared.tryPushBatch(batch, count);
+					}
+
+					i += pushed;
+					if (pushed == 0)
+						std::this_thread::yield();
+				}
+			});
+		}
+
+		uint32_t total = itemsPerProducer * (NUM_THREADS / 2);
+		for (uint32_t t = 0; t < NUM_THREADS / 2; t++) {
+			threads.emplace_back([&shared, &sum, &received, t, total] {
+				uint32_t batch[8];
+				while (received.load(std::memory_order_relaxed) < total) {
+					uint32_t count = t % 2 == 0 ? (shared.tryPop(batch[0]) ? 1 : 0) : shared.tryPopBatch(batch, 8);
+					for (uint32_t b = 0; b < count; b++)
+						sum.fetch_add(batch[b], std::memory_order_relaxed);
+
+					received.fetch_add(count, std::memory_order_relaxed);
+					if (count == 0)
+						std::this_thread::yield();
+				}
+			});
+		}
+
+		for (std::thread& thread : threads)
+			thread.join();
+
+		uint64_t expected = (uint64_t)itemsPerProducer * (itemsPerProducer + 1) / 2 * (NUM_THREADS / 2);
+		check(log, received.load() == total && sum.load() == expected, "MpmcQueue delivers every item once under contention"_fe);
+
+		// The single-producer queue preserves order across batches.
+		SpscQueue<uint32_t> ring(16);
+		bool ordered = true;
+		std::thread producer([&ring] {
+			uint32_t batch[5];
+			for (uint32_t i = 0; i < 10000;) {
+				for (uint32_t b = 0; b < 5; b++)
+					batch[b] = i + b;
+
+				uint32_t pushed = ring.pushBatch(batch, 10000 - i < 5 ? 10000 - i : 5);
+				i += pushed;
+				if (pushed == 0)
+					std::this_thread::yield();
+			}
+		});
+
+		uint32_t next = 0;
+		uint32_t batch[7];
+		while (next < 10000) {
+			uint32_t count = ring.popBatch(batch, 7);
+			for (uint32_t b = 0; b < count; b++)
+				ordered = ordered && batch[b] == next++;
+
+			if (count == 0)
+				std::this_thread::yield();
+		}
+
+		producer.join();
+		check(log, ordered, "SpscQueue keeps items in order"_fe);
+	}
+};
\ No newline at end of file
@@ -0,0 +1,84 @@
+#pragma once
+#include "stdafx.h"
+#include "test.hpp"
+#include "coroutine_scheduler.h"
+
+#ifdef FE_COROUTINES
+class TestCoroutines : public FerrousTest {
+public:
+
+	TestCoroutines() : FerrousTest("Coroutine Test") {}
+
+protected:
+	static Task<int> add(int a, int b) {
+		co_return a + b;
+	}
+
+	static Task<int> countDown(int n) {
+		if (n == 0)
+			co_return 0;
+
+		int result = co_await countDown(n - 1);
+		co_return result + 1;
+	}
+
+	static Task<int> fail() {
+		throw std::runtime_error("task failed");
+		co_return 0;
+	}
+
+	static Task<bool> awaitEmpty() {
+		Task<int> task = add(1, 2);
+		Task<int> taken = std::move(task);
+		try {
+			co_await task;
+		}
+		catch (const char*) {
+			co_return true;
+		}
+
+		co_return false;
+	}
+
+	static Task<> sequence(bool& added, bool& deep, bool& rethrown, bool& emptyThrew, int& stage) {
+		added = co_await add(2, 3) == 5;
+		deep = co_await countDown(1000) == 1000;
+
+		try {
+			co_await fail();
+		}
+		catch (const std::runtime_error&) {
+			rethrown = true;
+		}
+
+		emptyThrew = co_await awaitEmpty();
+
+		stage = 1;
+		co_await CoroutineScheduler::delay(50);
+		stage = 2;
+	}
+
+	void onRun(Logger& log) override {
+		bool added = false;
+		bool deep = false;
+		bool rethrown = false;
+		bool emptyThrew = false;
+		int stage = 0;
+
+		GameTime time(false);
+		CoroutineScheduler::spawn(sequence(added, deep, rethrown, emptyThrew, stage));
+		check(log, stage == 1, "spawn() runs a task until its first suspension"_fe);
+
+		auto start = std::chrono::steady_clock::now();
+		while (stage != 2 && std::chrono::steady_clock::now() - start < std::chrono::seconds(2)) {
+			time.tick();
+			CoroutineScheduler::update(&time);
+		}
+
+		check(log, added && deep, "co_await returns the result of a task"_fe);
+		check(log, rethrown, "co_await rethrows the exception of a task"_fe);
+		check(log, emptyThrew, "Awaiting an empty task throws"_fe);
+		check(log, stage == 2, "update() resumes a delayed task"_fe);
+	}
+};
+#endif
\ No newline at end of file
@@ -0,0 +1,61 @@
+#pragma once
+#include "stdafx.h"
+#include "test.hpp"
+#include "ferrous.h"
+#include <chrono>
+
+class TestGameTime : public FerrousTest {
+public:
+
+	TestGameTime() : FerrousTest("Game Time Test") {}
+
+protected:
+	/* Stops itself after a fixed number of updates. */
+	class CountingInstance : public FerrousInstance {
+	public:
+		uint32_t updates = 0;
+		uint32_t stopAfter = 30;
+
+	protected:
+		void onUpdate(GameTime* time) override {
+			if (++updates == stopAfter)
+				stop();
+		}
+
+		void onStart(GameTime* time, Settings* settings) override { }
+		void onStopping() override { }
+	};
+
+	void onRun(Logger& log) override {
+		// A constructed GameTime starts from its defaults, rather than whatever was left in the memory it was allocated from.
+		CountingInstance instance;
+		GameTime* time = instance.getTime();
+		check(log, time->getTargetFps() == 60 && time->getFixedTimestep() && time->getPacing() == FramePacing::SleepThenSpin && time->getFrameId() == 0,
+			"FerrousInstance constructs its GameTime"_fe);
+
+		// Only lower bounds on wall-clock time, since a busy machine can always make updates late, but pacing must never run them early.
+		auto start = std::chrono::steady_clock::now();
+		instance.start();
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		check(log, instance.updates == 30, "start() runs updates until stop()"_fe);
+		check(log, seconds > 0.4, "30 updates at 60 FPS take at least 29 frames"_fe);
+
+		// Sleeping pacing only returns once an update is due, and never gets ahead of the clock.
+		GameTime paced(true, 60, FramePacing::SleepThenSpin);
+		double initialMargin = paced.getSpinMargin();
+		uint32_t frames = 0;
+		uint32_t emptyTicks = 0;
+		start = std::chrono::steady_clock::now();
+		for (uint32_t i = 0; i < 30; i++) {
+			uint32_t updates = paced.tick();
+			frames += updates;
+			if (updates == 0)
+				emptyTicks++;
+		}
+
+		double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		check(log, emptyTicks == 0, "SleepThenSpin never returns without an update"_fe);
+		check(log, frames <= elapsedMs / paced.getTargetFrameTime() + 1, "SleepThenSpin never runs updates ahead of time"_fe);
+		check(log, paced.getSpinMargin() != initialMargin, "The spin margin adapts to measured sleeps"_fe);
+	}
+};
\ No newline at end of file
@@ -66,5 +66,28 @@ protected:
 		else {
 			log.writeLine("UTF-8 test file is missing.");
 		}
+
+		testUtf16Lines(log);
+	}
+
+	void testUtf16Lines(Logger& log) {
+		// "Ċx\ny" in UTF-16 LE, without a BOM. The low byte of 'Ċ' (U+010A) is the same as a UTF-8 new-line.
+		const char bytes[] = { 0x0A, 0x01, 0x78, 0x00, 0x0A, 0x00, 0x79, 0x00 };
+
+		FileStream utf16Out = FileStream(U"test_utf16.txt", FileStreamFlags::Create | FileStreamFlags::Binary, false, true);
+		utf16Out.writeBytes(bytes, sizeof(bytes));
+		utf16Out.close();
+
+		FileStream utf16In = FileStream(U"test_utf16.txt", FileStreamFlags::None, true, false, UtfEncoding::UTF16_LE);
+		TextStreamReader utf16Reader = TextStreamReader(&utf16In, Memory::get());
+
+		UtfString line;
+		utf16Reader.readLine(&line);
+		check(log, line.len() == 2 && line.byteLen() == 4 && memcmp(line.getData(), bytes, 4) == 0, "readLine() splits UTF-16 text on whole code units only");
+
+		UtfString rest;
+		utf16Reader.readToEnd(&rest);
+		check(log, rest.len() == 1 && rest.byteLen() == 2 && memcmp(rest.getData(), bytes + 6, 2) == 0, "readToEnd() returns the rest of the UTF-16 text");
+		utf16In.close();
 	}
 };
\ No newline at end of file
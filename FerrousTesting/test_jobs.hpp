@@ -0,0 +1,119 @@
+#pragma once
+#include "stdafx.h"
+#include "test.hpp"
+#include "job_system.h"
+#include "list.h"
+#include <atomic>
+#include <chrono>
+
+class TestJobs : public FerrousTest {
+public:
+
+	TestJobs() : FerrousTest("Job System Test") {}
+
+protected:
+	/* More continuations than the main thread has job slots, so the last of them cannot be allocated as jobs. */
+	const static uint32_t NUM_CONTINUATIONS = 20000;
+
+	struct DependencyState {
+		std::atomic<bool> dependencyDone = false;
+		std::atomic<uint32_t> ran = 0;
+		std::atomic<uint32_t> ranEarly = 0;
+	};
+
+	void onRun(Logger& log) override {
+		JobSystem::start();
+		log.writeLine(FeString::format("Started job system with %d threads"_fe, JobSystem::getThreadCount()));
+
+		// Run and wait.
+		std::atomic<uint32_t> total = 0;
+		JobCounter counter;
+		for (uint32_t i = 1; i <= 1000; i++)
+			JobSystem::run([&total, i] { total.fetch_add(i, std::memory_order_relaxed); }, &counter);
+
+		JobSystem::wait(counter);
+		check(log, total.load() == 500500, "run() then wait() completes every job"_fe);
+
+		// Continuations only run once their dependency completes, including those created after the thread runs out of job slots.
+		DependencyState state;
+		JobCounter dependency;
+		JobCounter after;
+		JobSystem::run([&state] {
+			auto until = std::chrono::steady_clock::now() + std::chrono::milliseconds(20);
+			while (std::chrono::steady_clock::now() < until)
+				std::this_thread::yield();
+
+			state.dependencyDone.store(true, std::memory_order_release);
+		}, &dependency);
+
+		for (uint32_t i = 0; i < NUM_CONTINUATIONS; i++) {
+			JobSystem::runAfter(dependency, [&state] {
+				if (!state.dependencyDone.load(std::memory_order_acquire))
+					state.ranEarly.fetch_add(1, std::memory_order_relaxed);
+
+				state.ran.fetch_add(1, std::memory_order_relaxed);
+			}, &after);
+		}
+
+		JobSystem::wait(after);
+		check(log, state.ran.load() == NUM_CONTINUATIONS, "runAfter() runs every continuation"_fe);
+		check(log, state.ranEarly.load() == 0, "runAfter() never runs before its dependency, even when out of job slots"_fe);
+
+		// parallelFor covers the range exactly once.
+		std::atomic<uint32_t> covered = 0;
+		std::atomic<uint32_t> overlaps = 0;
+		static uint8_t seen[100000];
+		memset(seen, 0, sizeof(seen));
+		JobSystem::parallelFor(100000, 64, [&](uint32_t start, uint32_t end) {
+			for (uint32_t i = start; i < end; i++) {
+				if (seen[i]++ != 0)
+					overlaps.fetch_add(1, std::memory_order_relaxed);
+			}
+
+			covered.fetch_add(end - start, std::memory_order_relaxed);
+		});
+		check(log, covered.load() == 100000 && overlaps.load() == 0, "parallelFor() visits each index once"_fe);
+
+		// parallelFor rethrows on the calling thread.
+		bool caught = false;
+		try {
+			JobSystem::parallelFor(1000, 10, [](uint32_t start, uint32_t end) {
+				if (start <= 500 && 500 < end)
+					throw std::runtime_error("chunk failed");
+			});
+		}
+		catch (const std::runtime_error&) {
+			caught = true;
+		}
+		check(log, caught, "parallelFor() rethrows the first exception"_fe);
+
+		// Jobs on every thread build strings and lists, and queue jobs of their own, more than fit in one page of job slots.
+		std::atomic<uint32_t> wrongStrings = 0;
+		std::atomic<uint32_t> children = 0;
+		JobCounter built;
+		for (uint32_t i = 0; i < 64; i++) {
+			JobSystem::run([&wrongStrings, &children, i] {
+				List<FeString> parts;
+				FeString joined;
+				for (uint32_t j = 0; j < 16; j++) {
+					parts.add("part "_fe + (i * 16 + j));
+					joined = joined + parts[j];
+				}
+
+				if (parts[15] != "part "_fe + (i * 16 + 15) || !joined.startsWith(&parts[0]))
+					wrongStrings.fetch_add(1, std::memory_order_relaxed);
+
+				JobCounter nested;
+				for (uint32_t c = 0; c < 200; c++)
+					JobSystem::run([&children] { children.fetch_add(1, std::memory_order_relaxed); }, &nested);
+
+				JobSystem::wait(nested);
+			}, &built);
+		}
+
+		JobSystem::wait(built);
+		check(log, wrongStrings.load() == 0 && children.load() == 64 * 200, "Jobs can allocate, and queue jobs, from any thread"_fe);
+
+		JobSystem::stop();
+	}
+};
\ No newline at end of file
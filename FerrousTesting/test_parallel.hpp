@@ -0,0 +1,144 @@
+#pragma once
+#include "stdafx.h"
+#include "test.hpp"
+#include "parallel.h"
+#include "list.h"
+
+class TestParallel : public FerrousTest {
+public:
+
+	TestParallel() : FerrousTest("Parallel Algorithms Test") {}
+
+protected:
+	const static uint32_t NUM_ITEMS = 100000;
+
+	struct Greater {
+		inline bool operator()(int a, int b) const { return a > b; }
+	};
+
+	/* Static, since they are too large for the stack. */
+	static inline uint32_t _items[NUM_ITEMS];
+	static inline uint64_t _wide[NUM_ITEMS];
+	static inline int _sorted[NUM_ITEMS];
+
+	void onRun(Logger& log) override {
+		testAll(log, " (serially)"_fe);
+
+		// Several workers, so the ranges really are split across threads, even on a machine with few cores.
+		JobSystem::start(3);
+		testAll(log, " (on the job system)"_fe);
+		JobSystem::stop();
+	}
+
+	void testAll(Logger& log, const FeString& mode) {
+		testForEach(log, mode);
+		testReduce(log, mode);
+		testScan(log, mode);
+		testSort(log, mode);
+	}
+
+	void testForEach(Logger& log, const FeString& mode) {
+		for (uint32_t i = 0; i < NUM_ITEMS; i++)
+			_items[i] = i;
+
+		parallel::forEach(_items, NUM_ITEMS, [](uint32_t& item) { item *= 2; });
+		bool doubled = true;
+		for (uint32_t i = 0; i < NUM_ITEMS; i++)
+			doubled = doubled && _items[i] == i * 2;
+		check(log, doubled, "forEach() visits every item once"_fe + mode);
+
+		parallel::transform(_items, _wide, NUM_ITEMS, [](uint32_t item) { return (uint64_t)item * 3; });
+		bool transformed = true;
+		for (uint32_t i = 0; i < NUM_ITEMS; i++)
+			transformed = transformed && _wide[i] == (uint64_t)i * 6;
+
+		List<int> src(1000);
+		List<int> dest(1000);
+		src.resize(1000);
+		dest.resize(1000);
+		for (uint32_t i = 0; i < 1000; i++)
+			src[i] = (int)i;
+
+		parallel::transform(src, dest, [](int item) { return -item; }, 16);
+		transformed = transformed && dest[0] == 0 && dest[999] == -999;
+
+		bool threw = false;
+		try {
+			dest.resize(10);
+			parallel::transform(src, dest, [](int item) { return item; });
+		}
+		catch (const IndexOutOfRangeExeption&) {
+			threw = true;
+		}
+		check(log, transformed && threw, "transform() fills the destination, and throws if it is too small"_fe + mode);
+	}
+
+	void testReduce(Logger& log, const FeString& mode) {
+		for (uint32_t i = 0; i < NUM_ITEMS; i++)
+			_wide[i] = 1;
+
+		uint64_t total = parallel::reduce(_wide, NUM_ITEMS, (uint64_t)0, [](uint64_t a, uint64_t b) { return a + b; });
+		uint64_t small = parallel::reduce(_wide, 10, (uint64_t)5, [](uint64_t a, uint64_t b) { return a + b; });
+		check(log, total == NUM_ITEMS && small == 15, "reduce() combines every chunk"_fe + mode);
+
+		// Concatenation is associative but not commutative, so chunks must be combined in order.
+		List<FeString> parts(200);
+		FeString expected;
+		for (uint32_t i = 0; i < 200; i++) {
+			parts.add("#"_fe + i);
+			expected = expected + parts[i];
+		}
+
+		FeString joined = parallel::reduce(parts, FeString(), [](const FeString& a, const FeString& b) { return a + b; }, 8);
+		check(log, joined == expected, "reduce() combines chunks in order"_fe + mode);
+	}
+
+	void testScan(Logger& log, const FeString& mode) {
+		for (uint32_t i = 0; i < NUM_ITEMS; i++)
+			_items[i] = 1;
+
+		parallel::scan(_items, _items, NUM_ITEMS, [](uint32_t a, uint32_t b) { return a + b; });
+		bool prefixed = true;
+		for (uint32_t i = 0; i < NUM_ITEMS; i++)
+			prefixed = prefixed && _items[i] == i + 1;
+
+		List<int> values(1000);
+		List<int> sums(1000);
+		values.resize(1000);
+		sums.resize(1000);
+		for (uint32_t i = 0; i < 1000; i++)
+			values[i] = (int)i;
+
+		parallel::scan(values, sums, [](int a, int b) { return a + b; }, 16);
+		check(log, prefixed && sums[0] == 0 && sums[10] == 55 && sums[999] == 499500, "scan() stores the inclusive prefix of every item"_fe + mode);
+	}
+
+	void testSort(Logger& log, const FeString& mode) {
+		uint32_t seed = 12345;
+		int64_t sum = 0;
+		for (uint32_t i = 0; i < NUM_ITEMS; i++) {
+			seed = seed * 1664525u + 1013904223u;
+			_sorted[i] = (int)(seed >> 8) - (1 << 23);
+			sum += _sorted[i];
+		}
+
+		parallel::sort(_sorted, NUM_ITEMS);
+		bool ordered = true;
+		int64_t sortedSum = 0;
+		for (uint32_t i = 0; i < NUM_ITEMS; i++) {
+			ordered = ordered && (i == 0 || _sorted[i - 1] <= _sorted[i]);
+			sortedSum += _sorted[i];
+		}
+		check(log, ordered && sortedSum == sum, "sort() orders every item"_fe + mode);
+
+		List<int> list(1000);
+		for (uint32_t i = 0; i < 1000; i++)
+			list.add((int)((i * 7919) % 1000));
+
+		parallel::sort(list, Greater(), 16);
+		bool descending = true;
+		for (uint32_t i = 0; i < 1000; i++)
+			descending = descending && list[i] == 999 - (int)i;
+		check(log, descending, "sort() honours its comparer"_fe + mode);
+	}
+};
\ No newline at end of file
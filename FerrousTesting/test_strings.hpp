@@ -2,6 +2,7 @@
 #include "stdafx.h"
 #include "test.hpp"
 #include "localization.h"
+#include "strings_number.h"
 
 using namespace std;
 class TestStrings : public FerrousTest {
@@ -86,5 +87,29 @@ protected:
 		cout << endl;
 		cout << "AFTER MEM DEFRAGMENTATION" << endl;
 		Memory::get()->outputDebug();
+		log.writeLine(U" ");
+
+		testNumbers(log);
+	}
+
+	void testNumbers(Logger& log) {
+		int32_t i32 = 0;
+		uint64_t u64 = 0;
+		double d = 0;
+
+		check(log, Number::tryParse("  -42 "_fe, i32) && i32 == -42, "Parses a signed integer"_fe);
+		check(log, !Number::tryParse("2147483648"_fe, i32), "Rejects an integer which does not fit"_fe);
+		check(log, Number::tryParse("1,234,567"_fe, u64) && u64 == 1234567, "Parses grouped digits"_fe);
+		check(log, Number::tryParse("12,345.5"_fe, d) && d == 12345.5, "Parses grouped digits before a decimal point"_fe);
+		check(log, !Number::tryParse("1,2,3"_fe, u64), "Rejects groups shorter than the group size"_fe);
+		check(log, !Number::tryParse("1234,567"_fe, u64), "Rejects a first group longer than the group size"_fe);
+		check(log, !Number::tryParse("1,234,56"_fe, u64) && !Number::tryParse("1,234,"_fe, u64), "Rejects a short last group"_fe);
+		check(log, !Number::tryParse(",123"_fe, u64) && !Number::tryParse("1,,234"_fe, u64), "Rejects separators without digits before them"_fe);
+		check(log, !Number::tryParse("1.234,5"_fe, d) && !Number::tryParse("12,34.5"_fe, d), "Rejects separators outside whole groups of integral digits"_fe);
+		check(log, Number::tryParse("1.5e-3"_fe, d) && d == 1.5e-3, "Parses an exponent"_fe);
+
+		check(log, Number::toString((int64_t)-1234567, true) == "-1,234,567"_fe, "Groups digits when printing"_fe);
+		check(log, Number::parse<uint64_t>(Number::toString((uint64_t)9876543210ULL, true)) == 9876543210ULL, "Parses its own grouped output"_fe);
+		check(log, Number::toString(0.1) == "0.1"_fe, "Prints the shortest round-trip form of a double"_fe);
 	}
 };
\ No newline at end of file
@@ -0,0 +1,123 @@
+#!/usr/bin/env python3
+"""Generates FerrousEngine/unicode_tables.cpp from the Unicode Character Database.
+
+Usage: generate_unicode_tables.py <path to UnicodeData.txt> [output path]
+
+UnicodeData.txt can be downloaded from https://www.unicode.org/Public/UCD/latest/ucd/UnicodeData.txt
+"""
+import sys
+
+MAX_CODEPOINT = 0x10FFFF
+BLOCK_SHIFT = 8  # Must match fe::Unicode::BLOCK_SHIFT.
+BLOCK_SIZE = 1 << BLOCK_SHIFT
+
+# Must match the order of fe::UnicodeCategory.
+CATEGORIES = ["Cn", "Lu", "Ll", "Lt", "Lm", "Lo", "Mn", "Mc", "Me", "Nd", "Nl", "No",
+              "Pc", "Pd", "Ps", "Pe", "Pi", "Pf", "Po", "Sm", "Sc", "Sk", "So",
+              "Zs", "Zl", "Zp", "Cc", "Cf", "Cs", "Co"]
+
+# The White_Space property from PropList.txt. It is not part of UnicodeData.txt and has been stable since Unicode 6.3.
+WHITESPACE = [0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x20, 0x85, 0xA0, 0x1680] + list(range(0x2000, 0x200B)) + \
+             [0x2028, 0x2029, 0x202F, 0x205F, 0x3000]
+
+# Must match the flag bits in fe::Unicode.
+FLAG_WHITESPACE = 1
+
+
+def parse(path):
+    category = [0] * (MAX_CODEPOINT + 1)
+    lower = list(range(MAX_CODEPOINT + 1))
+    upper = list(range(MAX_CODEPOINT + 1))
+    range_start = None
+
+    with open(path, encoding="utf-8") as f:
+        for line in f:
+            fields = line.rstrip("\n").split(";")
+            if len(fields) < 15:
+                continue
+
+            cp = int(fields[0], 16)
+            cat = CATEGORIES.index(fields[2])
+
+            # Large blocks, such as CJK ideographs, are given as a First/Last pair.
+            if fields[1].endswith(", First>"):
+                range_start = cp
+                continue
+
+            first = range_start if fields[1].endswith(", Last>") else cp
+            range_start = None
+
+            for c in range(first, cp + 1):
+                category[c] = cat
+
+            if fields[12]:
+                upper[cp] = int(fields[12], 16)
+            if fields[13]:
+                lower[cp] = int(fields[13], 16)
+
+    return category, lower, upper
+
+
+def main():
+    if len(sys.argv) < 2:
+        print(__doc__)
+        sys.exit(1)
+
+    out_path = sys.argv[2] if len(sys.argv) > 2 else "unicode_tables.cpp"
+    category, lower, upper = parse(sys.argv[1])
+    whitespace = set(WHITESPACE)
+
+    # Each code point maps to a record of (lower delta, upper delta, category, flags).
+    # Record 0 is reserved for unassigned code points without mappings, which is also used for anything above MAX_CODEPOINT.
+    records = [(0, 0, 0, 0)]
+    record_ids = {records[0]: 0}
+    blocks = []
+    block_ids = {}
+    stage1 = []
+
+    for block_start in range(0, MAX_CODEPOINT + 1, BLOCK_SIZE):
+        block = []
+        for cp in range(block_start, block_start + BLOCK_SIZE):
+            flags = FLAG_WHITESPACE if cp in whitespace else 0
+            rec = (lower[cp] - cp, upper[cp] - cp, category[cp], flags)
+            if rec not in record_ids:
+                record_ids[rec] = len(records)
+                records.append(rec)
+            block.append(record_ids[rec])
+
+        block = tuple(block)
+        if block not in block_ids:
+            block_ids[block] = len(blocks)
+            blocks.append(block)
+        stage1.append(block_ids[block])
+
+    assert len(records) <= 256, "Record index no longer fits in a uint8_t"
+    assert len(blocks) <= 256, "Block index no longer fits in a uint8_t"
+
+    def rows(values, per_row):
+        for i in range(0, len(values), per_row):
+            yield "\t\t" + ", ".join(str(v) for v in values[i:i + per_row]) + ","
+
+    with open(out_path, "w", encoding="utf-8", newline="\n") as out:
+        out.write("/* Generated by tools/generate_unicode_tables.py. Do not edit by hand. */\n")
+        out.write('#include "unicode.h"\n\n')
+        out.write("namespace fe {\n")
+        out.write("\tconst Unicode::Record Unicode::RECORDS[] = {\n")
+        for r in records:
+            out.write("\t\t{ %d, %d, %d, %d },\n" % r)
+        out.write("\t};\n\n")
+        out.write("\tconst uint8_t Unicode::STAGE1[] = {\n")
+        out.write("\n".join(rows(stage1, 32)) + "\n")
+        out.write("\t};\n\n")
+        out.write("\tconst uint8_t Unicode::STAGE2[] = {\n")
+        flat = [v for b in blocks for v in b]
+        out.write("\n".join(rows(flat, 32)) + "\n")
+        out.write("\t};\n")
+        out.write("}\n")
+
+    print("%d records, %d unique blocks, %d bytes" % (len(records), len(blocks),
+          len(records) * 12 + len(stage1) + len(blocks) * BLOCK_SIZE))
+
+
+if __name__ == "__main__":
+    main()